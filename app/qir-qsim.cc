@@ -5,14 +5,23 @@
 //---------------------------------------------------------------------------//
 //! \file qir-qsim/qir-qsim.cc
 //---------------------------------------------------------------------------//
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <thread>
 #include <CLI/CLI.hpp>
 
+#include "qiree/Assert.hh"
 #include "qiree/Executor.hh"
+#include "qiree/ExternalDistribution.hh"
 #include "qiree/Module.hh"
 #include "qiree/ResultDistribution.hh"
+#include "qiree/ResultSink.hh"
+#include "qiree/ShotScheduler.hh"
+#include "qiree/ShotWriter.hh"
 #include "qirqsim/QsimQuantum.hh"
 #include "qirqsim/QsimRuntime.hh"
 
@@ -23,24 +32,95 @@ namespace qiree
 namespace app
 {
 //---------------------------------------------------------------------------//
-void run(std::string const& filename, int num_shots)
+void run(std::string const& filename,
+         Executor::Options const& exec_opts,
+         int num_shots,
+         unsigned int num_threads,
+         QsimQuantum::Options sim_opts,
+         std::string const& format,
+         std::string const& output_filename,
+         std::string const& shots_filename,
+         std::string const& spill_filename,
+         size_type max_memory_bytes)
 {
+    QIREE_VALIDATE(spill_filename.empty() || format != "json",
+                   << "results spilled to disk must be written as ndjson, "
+                      "csv, or binary");
+
     // Load the input
-    Executor execute{Module{filename}};
+    Executor execute{Module{filename}, exec_opts};
+    if (exec_opts.opt_level != Module::OptLevel::O0)
+    {
+        std::clog << "qir-qsim: optimized at "
+                  << to_cstring(exec_opts.opt_level)
+                  << " in " << execute.optimize_time() << " s" << std::endl;
+    }
+
+    // By default, share the cores among the simulators
+    sim_opts = worker_options(sim_opts, 0, num_threads);
+
+    // Report the simulator configuration on the diagnostic stream, since the
+    // results are written to stdout
+    std::clog << "qir-qsim: using " << to_cstring(select_isa(sim_opts))
+              << " instructions, " << to_cstring(sim_opts.precision)
+              << " precision, " << sim_opts.num_threads
+              << " thread(s) per simulator" << std::endl;
+
+    // Set up qsim: one simulator per thread, each pinned to its own CPUs if
+    // requested
+    auto make_backend
+        = [sim_opts, num_threads, worker = 0u](unsigned long int seed) mutable {
+              auto sim = std::make_shared<QsimQuantum>(
+                  std::cout,
+                  seed,
+                  worker_options(sim_opts, worker++, num_threads));
+              auto rt = std::make_shared<QsimRuntime>(std::cout, *sim);
+              return ShotScheduler::Backend{std::move(sim), std::move(rt)};
+          };
+    constexpr unsigned long int seed = 0;
+    ShotScheduler run_shots{execute, make_backend, {num_threads, seed}};
+
+    // Run several time = shots (default 1), optionally saving each one
+    std::optional<ShotWriter> shots;
+    if (!shots_filename.empty())
+    {
+        shots.emplace(shots_filename);
+    }
 
-    // Set up qsim
-    QsimQuantum sim(std::cout, 0);
-    QsimRuntime rt(std::cout, sim);
-    ResultDistribution distribution;
+    std::ofstream outfile;
+    if (!output_filename.empty())
+    {
+        outfile.open(output_filename, std::ios::binary);
+        QIREE_VALIDATE(outfile,
+                       << "failed to open output file '" << output_filename
+                       << "'");
+    }
+    std::ostream& os = output_filename.empty() ? std::cout : outfile;
 
-    // Run several time = shots (default 1)
-    for (int i = 0; i < num_shots; i++)
+    if (!spill_filename.empty())
     {
-        execute(sim, rt);
-        distribution.accumulate(rt.result());
+        // Count results in batches, spilling the counts to disk as needed
+        ExternalDistribution distribution{spill_filename, max_memory_bytes};
+        run_shots(num_shots, distribution, shots ? &*shots : nullptr);
+        if (distribution.num_runs() > 0)
+        {
+            std::clog << "qir-qsim: spilled counts to disk "
+                      << distribution.num_runs() << " time(s)" << std::endl;
+        }
+        auto sink = make_result_sink(to_result_format(format), os);
+        sink->write({}, distribution);
+        return;
     }
 
-    std::cout << distribution.to_json() << std::endl;
+    ResultDistribution distribution
+        = run_shots(num_shots, shots ? &*shots : nullptr);
+    if (format == "json")
+    {
+        os << distribution.to_json() << std::endl;
+        return;
+    }
+    auto sink = make_result_sink(to_result_format(format), os);
+    sink->write({}, distribution);
 }
 
 //---------------------------------------------------------------------------//
@@ -54,7 +134,20 @@ void run(std::string const& filename, int num_shots)
 int main(int argc, char* argv[])
 {
     int num_shots{1};
+    unsigned int num_threads{1};
     std::string filename;
+    qiree::QsimQuantum::Options sim_opts;
+    std::string affinity{to_cstring(sim_opts.affinity)};
+    std::string precision{to_cstring(sim_opts.precision)};
+    std::string isa{to_cstring(sim_opts.isa)};
+    std::string format{"json"};
+    std::string output_filename;
+    std::string shots_filename;
+    std::string spill_filename;
+    qiree::size_type max_memory_mib
+        = qiree::ExternalDistribution::default_max_memory_bytes >> 20;
+    qiree::Executor::Options exec_opts;
+    std::string opt_level{to_cstring(exec_opts.opt_level)};
 
     CLI::App app;
 
@@ -66,9 +159,98 @@ int main(int argc, char* argv[])
         = app.add_option("-s,--shots", num_shots, "Number of shots");
     nshot_opt->capture_default_str();
 
+    auto* nthread_opt = app.add_option(
+        "-t,--threads", num_threads, "Number of threads (0 for all cores)");
+    nthread_opt->capture_default_str();
+
+    auto* fused_opt = app.add_option("--fused-size",
+                                     sim_opts.max_fused_size,
+                                     "Maximum number of qubits in a fused "
+                                     "gate (1-6)");
+    fused_opt->capture_default_str();
+
+    app.add_option("--sim-threads",
+                   sim_opts.num_threads,
+                   "Number of threads per simulator (0 to divide the cores "
+                   "among the shot threads)");
+
+    auto* affinity_opt = app.add_option(
+        "--affinity", affinity, "Simulator thread binding (none, compact)");
+    affinity_opt->capture_default_str();
+
+    app.add_option(
+        "--first-cpu", sim_opts.first_cpu, "First CPU for compact binding");
+
+    auto* precision_opt = app.add_option(
+        "--precision", precision, "State vector precision (single, double)");
+    precision_opt->capture_default_str();
+
+    auto* isa_opt = app.add_option(
+        "--isa",
+        isa,
+        "Simulator instruction set (auto, avx512, avx2, sse4, basic)");
+    isa_opt->capture_default_str();
+
+    auto* format_opt = app.add_option(
+        "--format",
+        format,
+        "Result distribution format (json, ndjson, csv, binary)");
+    format_opt->capture_default_str();
+
+    app.add_option("-o,--output",
+                   output_filename,
+                   "Write the result distribution to a file instead of "
+                   "stdout");
+
+    app.add_option("--shot-file",
+                   shots_filename,
+                   "Write every shot's results, in order, to a binary file");
+
+    auto* spill_opt
+        = app.add_option("--spill-file",
+                         spill_filename,
+                         "Scratch file for result counts that exceed the "
+                         "memory limit (requires ndjson, csv, or binary "
+                         "format)");
+
+    auto* max_memory_opt
+        = app.add_option("--max-memory",
+                         max_memory_mib,
+                         "Memory for result counts before spilling [MiB]");
+    max_memory_opt->capture_default_str();
+    max_memory_opt->needs(spill_opt);
+
+    app.add_option("--object-cache",
+                   exec_opts.object_cache_dir,
+                   "Directory for reusing code compiled by earlier runs");
+
+    auto* opt_level_opt = app.add_option(
+        "--opt-level",
+        opt_level,
+        "Optimization applied before compiling (O0, O1, O2, O3, qir)");
+    opt_level_opt->capture_default_str();
+
+    app.add_flag("--direct-runtime",
+                 exec_opts.direct_runtime,
+                 "Buffer gates and output records in compiled code instead of "
+                 "calling the simulator for each one");
+
     CLI11_PARSE(app, argc, argv);
 
-    qiree::app::run(filename, num_shots);
+    exec_opts.opt_level = qiree::to_opt_level(opt_level);
+    qiree::set_option(sim_opts, "affinity", affinity);
+    qiree::set_option(sim_opts, "precision", precision);
+    qiree::set_option(sim_opts, "isa", isa);
+    qiree::app::run(filename,
+                    exec_opts,
+                    num_shots,
+                    num_threads,
+                    sim_opts,
+                    format,
+                    output_filename,
+                    shots_filename,
+                    spill_filename,
+                    max_memory_mib << 20);
 
     return EXIT_SUCCESS;
 }
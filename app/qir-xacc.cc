@@ -6,18 +6,25 @@
 //! \file qir-xacc/qir-xacc.cc
 //---------------------------------------------------------------------------//
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <CLI/CLI.hpp>
 
 #include "qiree_version.h"
 
+#include "qiree/Assert.hh"
 #include "qiree/Executor.hh"
 #include "qiree/Module.hh"
 #include "qiree/QuantumNotImpl.hh"
+#include "qiree/ResultDistribution.hh"
+#include "qiree/ResultSink.hh"
+#include "qiree/ShotScheduler.hh"
 #include "qirxacc/XaccDefaultRuntime.hh"
 #include "qirxacc/XaccQuantum.hh"
+#include "qirxacc/XaccShotRuntime.hh"
 #include "qirxacc/XaccTupleRuntime.hh"
 
 using namespace std::string_view_literals;
@@ -26,28 +33,104 @@ namespace qiree
 {
 namespace app
 {
+//---------------------------------------------------------------------------//
+/*!
+ * Run one shot at a time, sampling the circuit whenever a result is read.
+ */
+void run_dynamic(Executor const& execute,
+                 std::string const& accel_name,
+                 int num_shots,
+                 std::ostream& os,
+                 ResultSink* sink)
+{
+    // XACC is not thread safe, so use a single worker. Diagnostics are kept
+    // out of the result stream.
+    auto make_backend = [&accel_name, num_shots](unsigned long int seed) {
+        XaccQuantum::Options opts;
+        opts.shots = static_cast<size_type>(num_shots);
+        opts.dynamic = true;
+        opts.seed = seed;
+        auto xacc = std::make_shared<XaccQuantum>(std::clog, accel_name, opts);
+        auto rt = std::make_shared<XaccShotRuntime>(std::clog, *xacc);
+        return ShotScheduler::Backend{std::move(xacc), std::move(rt)};
+    };
+    constexpr unsigned long int seed = 0;
+    ShotScheduler run_shots{execute, make_backend, {1, seed}};
+
+    ResultDistribution distribution = run_shots(num_shots);
+    if (sink)
+    {
+        sink->write({}, distribution);
+        return;
+    }
+    os << distribution.to_json() << std::endl;
+}
+
 //---------------------------------------------------------------------------//
 void run(std::string const& filename,
+         Executor::Options const& exec_opts,
          std::string const& accel_name,
          int num_shots,
          bool print_accelbuf,
-         bool group_tuples)
+         bool group_tuples,
+         bool dynamic,
+         std::string const& cache_dir,
+         std::string const& format,
+         std::string const& output_filename)
 {
     // Load the input
-    Executor execute{Module{filename}};
+    Executor execute{Module{filename}, exec_opts};
+    if (exec_opts.opt_level != Module::OptLevel::O0)
+    {
+        std::clog << "qir-xacc: optimized at "
+                  << to_cstring(exec_opts.opt_level)
+                  << " in " << execute.optimize_time() << " s" << std::endl;
+    }
+
+    // Set up the output
+    std::ofstream outfile;
+    if (!output_filename.empty())
+    {
+        outfile.open(output_filename, std::ios::binary);
+        QIREE_VALIDATE(outfile,
+                       << "failed to open output file '" << output_filename
+                       << "'");
+    }
+    std::ostream& os = output_filename.empty() ? std::cout : outfile;
+    std::unique_ptr<ResultSink> sink;
+    if (format != "text")
+    {
+        sink = make_result_sink(to_result_format(format), os);
+    }
+
+    if (!dynamic && execute.analysis().result_feedback)
+    {
+        std::clog << "qir-xacc: program branches on measured results: "
+                     "running in dynamic mode"
+                  << std::endl;
+        dynamic = true;
+    }
+    if (dynamic)
+    {
+        return run_dynamic(execute, accel_name, num_shots, os, sink.get());
+    }
 
     // Set up XACC
-    XaccQuantum xacc(std::cout, accel_name, num_shots);
+    XaccQuantum::Options opts;
+    opts.shots = static_cast<size_type>(num_shots);
+    opts.cache_dir = cache_dir;
+    // Only records may be written to the stream of a result sink
+    XaccQuantum xacc(sink ? std::clog : std::cout, accel_name, opts);
     std::unique_ptr<RuntimeInterface> rt;
     if (group_tuples)
     {
         rt = std::make_unique<XaccTupleRuntime>(
-            std::cout, xacc, print_accelbuf);
+            os, xacc, print_accelbuf, sink.get());
     }
     else
     {
         rt = std::make_unique<XaccDefaultRuntime>(
-            std::cout, xacc, print_accelbuf);
+            os, xacc, print_accelbuf, sink.get());
     }
 
     // Run
@@ -69,6 +152,12 @@ int main(int argc, char* argv[])
     std::string filename;
     bool no_print_accelbuf{false};
     bool group_tuples{false};
+    bool dynamic{false};
+    std::string cache_dir;
+    std::string format{"text"};
+    std::string output_filename;
+    qiree::Executor::Options exec_opts;
+    std::string opt_level{to_cstring(exec_opts.opt_level)};
 
     CLI::App app;
     auto* filename_opt
@@ -87,11 +176,49 @@ int main(int argc, char* argv[])
                  group_tuples,
                  "Print per-tuple/per-array measurement statistics rather "
                  "than per-qubit");
+    app.add_flag("--dynamic",
+                 dynamic,
+                 "Run one shot at a time, executing the circuit whenever a "
+                 "result is read (default for programs with feedback)");
+    app.add_option("--circuit-cache",
+                   cache_dir,
+                   "Directory for reusing XACC circuits built by earlier runs");
+    app.add_option("--object-cache",
+                   exec_opts.object_cache_dir,
+                   "Directory for reusing code compiled by earlier runs");
+    auto* opt_level_opt = app.add_option(
+        "--opt-level",
+        opt_level,
+        "Optimization applied before compiling (O0, O1, O2, O3, qir)");
+    opt_level_opt->capture_default_str();
+    app.add_flag("--direct-runtime",
+                 exec_opts.direct_runtime,
+                 "Buffer gates and output records in compiled code instead of "
+                 "calling the accelerator interface for each one");
+    auto* format_opt
+        = app.add_option("--format",
+                         format,
+                         "Result format (text, ndjson, csv, binary)");
+    format_opt->capture_default_str();
+    app.add_option("-o,--output",
+                   output_filename,
+                   "Write results to a file instead of stdout");
 
     CLI11_PARSE(app, argc, argv);
 
-    qiree::app::run(
-        filename, accel_name, num_shots, !no_print_accelbuf, group_tuples);
+    exec_opts.opt_level = qiree::to_opt_level(opt_level);
+    // Circuits are only reused across runs through the on-disk cache
+    exec_opts.hash_module = !cache_dir.empty();
+    qiree::app::run(filename,
+                    exec_opts,
+                    accel_name,
+                    num_shots,
+                    !no_print_accelbuf,
+                    group_tuples,
+                    dynamic,
+                    cache_dir,
+                    format,
+                    output_filename);
 
     return EXIT_SUCCESS;
 }
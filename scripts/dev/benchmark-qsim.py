@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+# Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+# See the top-level COPYRIGHT file for details.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""\
+Time qir-qsim over a corpus of QIR examples for a sweep of simulator options.
+
+Each combination of options is run on every input file, and the wall-clock
+time of the fastest of several repetitions is written as CSV to stdout.
+
+Example::
+
+    scripts/dev/benchmark-qsim.py --exe build/bin/qir-qsim \\
+        --fused-size 2 4 6 --sim-threads 1 4 --precision single double \\
+        examples/*.ll
+"""
+
+import argparse
+import csv
+import itertools
+import subprocess
+import sys
+import time
+
+###############################################################################
+
+
+def time_run(cmd, repeat):
+    """Return the best wall-clock time of a command, or None on failure."""
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = subprocess.run(cmd, stdout=subprocess.DEVNULL,
+                                stderr=subprocess.PIPE, text=True)
+        elapsed = time.perf_counter() - start
+        if result.returncode != 0:
+            print(f"failed: {' '.join(cmd)}\n{result.stderr}",
+                  file=sys.stderr)
+            return None
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('inputs', nargs='+', help="QIR input files")
+    parser.add_argument('--exe', default='qir-qsim',
+                        help="path to the qir-qsim executable")
+    parser.add_argument('--shots', type=int, default=1000)
+    parser.add_argument('--threads', type=int, nargs='+', default=[1],
+                        help="shot scheduler threads")
+    parser.add_argument('--fused-size', type=int, nargs='+', default=[2])
+    parser.add_argument('--sim-threads', type=int, nargs='+', default=[0])
+    parser.add_argument('--affinity', nargs='+', default=['none'],
+                        choices=['none', 'compact'])
+    parser.add_argument('--precision', nargs='+', default=['single'],
+                        choices=['single', 'double'])
+    parser.add_argument('--isa', nargs='+', default=['auto'],
+                        choices=['auto', 'avx512', 'avx2', 'sse4', 'basic'])
+    parser.add_argument('--repeat', type=int, default=3,
+                        help="repetitions per configuration")
+    args = parser.parse_args()
+
+    sweep = list(itertools.product(args.threads, args.fused_size,
+                                   args.sim_threads, args.affinity,
+                                   args.precision, args.isa))
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(['input', 'threads', 'fused_size', 'sim_threads',
+                     'affinity', 'precision', 'isa', 'seconds'])
+    for filename in args.inputs:
+        for (threads, fused, sim_threads, affinity, precision,
+             isa) in sweep:
+            cmd = [args.exe, filename,
+                   '--shots', str(args.shots),
+                   '--threads', str(threads),
+                   '--fused-size', str(fused),
+                   '--sim-threads', str(sim_threads),
+                   '--affinity', affinity,
+                   '--precision', precision,
+                   '--isa', isa]
+            seconds = time_run(cmd, args.repeat)
+            writer.writerow([filename, threads, fused, sim_threads, affinity,
+                             precision, isa,
+                             '' if seconds is None else f"{seconds:.4f}"])
+            sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
@@ -104,6 +104,16 @@ QireeReturnCode qiree_setup_executor(CQiree* manager,
         cpp_manager->setup_executor(backend_sv, config_sv));
 }
 
+QireeReturnCode qiree_set_num_threads(CQiree* manager, int num_threads)
+{
+    if (!manager)
+        return QIREE_NOT_READY;
+
+    auto* cpp_manager = reinterpret_cast<QM*>(manager);
+    return static_cast<QireeReturnCode>(
+        cpp_manager->set_num_threads(num_threads));
+}
+
 QireeReturnCode qiree_execute(CQiree* manager, int num_shots)
 {
     if (!manager)
@@ -53,11 +53,22 @@ QireeReturnCode qiree_num_classical_reg(CQiree* manager, int* result);
 QireeReturnCode
 qiree_max_result_items(CQiree* manager, int num_shots, size_t* result);
 
-/* Executor setup and execution: config_json may be null */
+/*
+ * Executor setup and execution: config_json may be null, or else must be a
+ * JSON object whose values are strings, numbers, or booleans, e.g.
+ * {"max_fused_size": 4, "precision": "double"}. Nested objects, arrays, and
+ * null are rejected. Each value is passed to the backend as a string: strings
+ * unquoted and unescaped, other values as written. Besides the backend
+ * options, "object_cache" names a directory for reusing compiled code and
+ * "opt_level" (O0, O1, O2, O3, qir) selects the optimization before compiling.
+ */
 QireeReturnCode qiree_setup_executor(CQiree* manager,
                                      char const* backend,
                                      char const* config_json);
 
+/* Number of threads used to execute shots: zero uses all available cores */
+QireeReturnCode qiree_set_num_threads(CQiree* manager, int num_threads);
+
 QireeReturnCode qiree_execute(CQiree* manager, int num_shots);
 
 /*
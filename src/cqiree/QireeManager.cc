@@ -7,17 +7,23 @@
 //---------------------------------------------------------------------------//
 #include "QireeManager.hh"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "qiree_config.h"
 
 #include "qiree/Assert.hh"
 #include "qiree/Executor.hh"
+#include "qiree/JsonConfig.hh"
 #include "qiree/Module.hh"
 #include "qiree/QuantumInterface.hh"
 #include "qiree/ResultDistribution.hh"
+#include "qiree/ShotScheduler.hh"
 #include "qiree/SingleResultRuntime.hh"
 #include "qirqsim/QsimQuantum.hh"
 #include "qirqsim/QsimRuntime.hh"
@@ -41,9 +47,7 @@ QireeManager::load_module(std::string_view data_contents) throw()
 {
     try
     {
-        // Convert string_view to string for Module constructor
-        std::string content{data_contents};
-        module_ = Module::from_bytes(content);
+        module_ = Module::from_bytes(data_contents);
     }
     catch (std::exception const& e)
     {
@@ -146,23 +150,58 @@ QireeManager::setup_executor(std::string_view backend,
         CQIREE_FAIL(not_ready, "cannot create executor again");
     }
 
+    Executor::Options exec_opts;
     try
     {
+        ConfigItems config;
         if (!config_json.empty())
         {
-            QIREE_NOT_IMPLEMENTED("CQiree JSON configuration input");
+            config = parse_json_config(config_json);
         }
 
+        // Remove the options shared by all backends
+        auto is_executor_option = [&exec_opts](auto const& item) {
+            if (item.first == "object_cache")
+            {
+                exec_opts.object_cache_dir = item.second;
+                return true;
+            }
+            if (item.first == "opt_level")
+            {
+                exec_opts.opt_level = to_opt_level(item.second);
+                return true;
+            }
+            return false;
+        };
+        config.erase(
+            std::remove_if(config.begin(), config.end(), is_executor_option),
+            config.end());
+
         if (backend == "qsim")
         {
 #if QIREE_USE_QSIM
-            // Create runtime interface: give runtime a pointer to quantum
-            // (lifetime of the reference is guaranteed by our shared pointer
-            // copy)
-            constexpr unsigned long int seed = 0;
-            auto quantum = std::make_shared<QsimQuantum>(std::cout, seed);
-            runtime_ = std::make_shared<QsimRuntime>(std::cout, *quantum);
-            quantum_ = std::move(quantum);
+            QsimQuantum::Options opts;
+            for (auto const& [key, value] : config)
+            {
+                set_option(opts, key, value);
+            }
+
+            // Create a quantum and runtime interface for each worker: the
+            // runtime references the quantum interface, whose lifetime is
+            // guaranteed by the shared pointer in the backend. Unless
+            // specified, the cores are divided among the workers, and each
+            // worker is bound to its own CPUs if requested.
+            make_backend_ = [this, opts, worker = 0u](
+                                unsigned long int seed) mutable {
+                auto quantum = std::make_shared<QsimQuantum>(
+                    std::cout,
+                    seed,
+                    worker_options(opts, worker++, num_threads_));
+                auto runtime
+                    = std::make_shared<QsimRuntime>(std::cout, *quantum);
+                return ShotScheduler::Backend{std::move(quantum),
+                                              std::move(runtime)};
+            };
 #else
             QIREE_NOT_CONFIGURED("QSim");
 #endif
@@ -191,7 +230,7 @@ QireeManager::setup_executor(std::string_view backend,
     {
         // Create executor with the module, quantum and runtime interfaces
         QIREE_ASSERT(module_ && *module_);
-        execute_ = std::make_unique<Executor>(std::move(*module_));
+        execute_ = std::make_unique<Executor>(std::move(*module_), exec_opts);
     }
     catch (std::exception const& e)
     {
@@ -201,6 +240,23 @@ QireeManager::setup_executor(std::string_view backend,
     return ReturnCode::success;
 }
 
+//---------------------------------------------------------------------------//
+QireeManager::ReturnCode QireeManager::set_num_threads(int num_threads) throw()
+{
+    if (num_threads < 0)
+    {
+        CQIREE_FAIL(invalid_input, "num_threads was negative");
+    }
+
+    if (static_cast<unsigned int>(num_threads) != num_threads_)
+    {
+        // Backends will be recreated on the next execution
+        num_threads_ = static_cast<unsigned int>(num_threads);
+        run_shots_.reset();
+    }
+    return ReturnCode::success;
+}
+
 //---------------------------------------------------------------------------//
 QireeManager::ReturnCode QireeManager::execute(int num_shots) throw()
 {
@@ -216,14 +272,18 @@ QireeManager::ReturnCode QireeManager::execute(int num_shots) throw()
 
     try
     {
-        QIREE_ASSERT(runtime_ && quantum_);
-        result_ = std::make_unique<ResultDistribution>();
-
-        for (auto i = 0; i < num_shots; ++i)
+        if (!run_shots_)
         {
-            (*execute_)(*quantum_, *runtime_);
-            result_->accumulate(runtime_->result());
+            // Create backends the first time shots are executed
+            QIREE_ASSERT(make_backend_);
+            constexpr unsigned long int seed = 0;
+            run_shots_ = std::make_unique<ShotScheduler>(
+                *execute_,
+                make_backend_,
+                ShotScheduler::Options{num_threads_, seed});
         }
+        result_
+            = std::make_unique<ResultDistribution>((*run_shots_)(num_shots));
     }
     catch (std::exception const& e)
     {
@@ -249,21 +309,20 @@ QireeManager::save_result_items(ResultRecord* encoded,
                                              << result_->size() + 1);
     }
 
-    try
+    if (result_->num_bits() == 0 || result_->num_bits() > 64)
     {
-        // Save number of records
-        *encoded++ = {0, result_->size()};
-        for (auto&& [bitstring, count] : *result_)
-        {
-            std::uint64_t bitint{0};
-            encode_bit_string(bitstring, bitint);
-            *encoded++ = {bitint, count};
-        }
-    }
-    catch (std::exception const& e)
-    {
-        CQIREE_FAIL(fail_execute, e.what());
+        CQIREE_FAIL(fail_execute,
+                    "invalid key size: must be between 1 and 64 bits: got "
+                        << result_->num_bits() << " bits");
     }
+
+    // Save number of records, then the packed keys (already in the
+    // little-endian encoding of encode_bit_string)
+    *encoded++ = {0, result_->size()};
+    result_->for_each_packed(
+        [&encoded](std::uint64_t const* key, std::size_t count) {
+            *encoded++ = {key[0], count};
+        });
     return ReturnCode::success;
 }
 //---------------------------------------------------------------------------//
@@ -14,12 +14,12 @@
 #include <string>
 #include <string_view>
 
+#include "qiree/ShotScheduler.hh"
+
 namespace qiree
 {
 class Executor;
 class Module;
-class QuantumInterface;
-class SingleResultRuntime;
 class ResultDistribution;
 
 //---------------------------------------------------------------------------//
@@ -60,6 +60,8 @@ class QireeManager
     ReturnCode max_result_items(int num_shots, std::size_t& result) const
         throw();
 
+    ReturnCode set_num_threads(int num_threads) throw();
+
     ReturnCode execute(int num_shots) throw();
 
     ReturnCode
@@ -68,8 +70,9 @@ class QireeManager
   private:
     std::unique_ptr<Module> module_;
     std::unique_ptr<Executor> execute_;
-    std::shared_ptr<QuantumInterface> quantum_;
-    std::shared_ptr<SingleResultRuntime> runtime_;
+    ShotScheduler::BackendFactory make_backend_;
+    unsigned int num_threads_{1};
+    std::unique_ptr<ShotScheduler> run_shots_;
     std::unique_ptr<ResultDistribution> result_;
 };
 
@@ -0,0 +1,66 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/AtomicWrite.cc
+//---------------------------------------------------------------------------//
+#include "AtomicWrite.hh"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Write a whole file so that readers never see it partially written.
+ *
+ * The data is written to a uniquely named temporary file next to the target,
+ * which is then renamed over it. Concurrent writers of the same path
+ * therefore never share a temporary file, and the last rename wins. The
+ * parent directory is created if needed. On failure the temporary file is
+ * removed and the error is returned.
+ */
+std::error_code write_atomic(std::string const& path, std::string_view data)
+{
+    auto dir = llvm::sys::path::parent_path(path);
+    if (!dir.empty())
+    {
+        if (auto ec = llvm::sys::fs::create_directories(dir))
+        {
+            return ec;
+        }
+    }
+
+    int fd = -1;
+    llvm::SmallString<256> temp_path;
+    if (auto ec = llvm::sys::fs::createUniqueFile(
+            path + ".%%%%%%.tmp", fd, temp_path))
+    {
+        return ec;
+    }
+    {
+        llvm::raw_fd_ostream os{fd, /* shouldClose = */ true};
+        os << llvm::StringRef{data.data(), data.size()};
+        os.close();
+        if (auto ec = os.error())
+        {
+            os.clear_error();
+            llvm::sys::fs::remove(temp_path);
+            return ec;
+        }
+    }
+    if (auto ec = llvm::sys::fs::rename(temp_path, path))
+    {
+        llvm::sys::fs::remove(temp_path);
+        return ec;
+    }
+    return {};
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
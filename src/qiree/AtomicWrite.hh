@@ -0,0 +1,24 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/AtomicWrite.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Write a whole file so that readers never see it partially written
+std::error_code write_atomic(std::string const& path, std::string_view data);
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -7,20 +7,34 @@
 //---------------------------------------------------------------------------//
 #include "Executor.hh"
 
-#include <iostream>
-#include <llvm/ExecutionEngine/ExecutionEngine.h>
-#include <llvm/ExecutionEngine/GenericValue.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
 
 #include "Assert.hh"
 #include "Module.hh"
+#include "OpTape.hh"
 #include "QuantumInterface.hh"
 #include "RuntimeInterface.hh"
+#include "detail/DirectRuntime.hh"
 #include "detail/EndGuard.hh"
 #include "detail/GlobalMapper.hh"
+#include "detail/JitObjectCache.hh"
 
 namespace qiree
 {
@@ -30,11 +44,75 @@ namespace
 /*!
  * Pointer to active interfaces.
  *
- * LLVM's addGlobalMapping requires a global function symbol rather than a
- * std::function.
+ * The JIT requires the address of a global function rather than a
+ * std::function. The pointers are thread-local so that a single compiled
+ * module can be executed concurrently by multiple threads, each with its own
+ * pair of interfaces.
  */
-static QuantumInterface* q_interface_{nullptr};
-static RuntimeInterface* r_interface_{nullptr};
+thread_local QuantumInterface* q_interface_{nullptr};
+thread_local RuntimeInterface* r_interface_{nullptr};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Operations written by compiled code with the direct runtime.
+ *
+ * The buffer is empty (and all its pointers null) unless the active executor
+ * uses the direct runtime.
+ */
+thread_local detail::DirectBuffer direct_buffer_;
+thread_local std::vector<OpTape::Op> direct_ops_;
+
+//! Maximum number of operations written before they are applied
+constexpr size_type direct_capacity{256};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the calling thread's operation buffer.
+ */
+detail::DirectBuffer* direct_buffer()
+{
+    return &direct_buffer_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply and remove buffered operations.
+ */
+void direct_flush()
+{
+    OpTape::Op const* const end = direct_buffer_.pos;
+    direct_buffer_.pos = direct_buffer_.begin;
+    for (OpTape::Op const* op = direct_buffer_.begin; op != end; ++op)
+    {
+        OpTape::apply(*op, *q_interface_, *r_interface_);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the quantum interface after applying any buffered operations.
+ */
+QuantumInterface& quantum()
+{
+    if (direct_buffer_.pos != direct_buffer_.begin)
+    {
+        direct_flush();
+    }
+    return *q_interface_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the runtime interface after applying any buffered operations.
+ */
+RuntimeInterface& runtime()
+{
+    if (direct_buffer_.pos != direct_buffer_.begin)
+    {
+        direct_flush();
+    }
+    return *r_interface_;
+}
 
 //---------------------------------------------------------------------------//
 //! Generate a function name without a specialization suffix
@@ -55,24 +133,24 @@ static RuntimeInterface* r_interface_{nullptr};
 //---------------------------------------------------------------------------//
 std::uintptr_t QIREE_QIS_FUNCTION(m, body)(std::uintptr_t arg1)
 {
-    return q_interface_->m(Qubit{arg1}).value;
+    return quantum().m(Qubit{arg1}).value;
 }
 std::uintptr_t
 QIREE_QIS_FUNCTION(measure, body)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->measure(Array{arg1}, Array{arg2}).value;
+    return quantum().measure(Array{arg1}, Array{arg2}).value;
 }
 std::uintptr_t QIREE_QIS_FUNCTION(mresetz, body)(std::uintptr_t arg1)
 {
-    return q_interface_->mresetz(Qubit{arg1}).value;
+    return quantum().mresetz(Qubit{arg1}).value;
 }
 void QIREE_QIS_FUNCTION(mz, body)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->mz(Qubit{arg1}, Result{arg2});
+    return quantum().mz(Qubit{arg1}, Result{arg2});
 }
 bool QIREE_QIS_FUNCTION(read_result, body)(std::uintptr_t arg1)
 {
-    return static_cast<bool>(q_interface_->read_result(Result{arg1}));
+    return static_cast<bool>(quantum().read_result(Result{arg1}));
 }
 //---------------------------------------------------------------------------//
 // GATES
@@ -81,175 +159,175 @@ void QIREE_QIS_FUNCTION(ccx, body)(std::uintptr_t arg1,
                                    std::uintptr_t arg2,
                                    std::uintptr_t arg3)
 {
-    return q_interface_->ccx(Qubit{arg1}, Qubit{arg2}, Qubit{arg3});
+    return quantum().ccx(Qubit{arg1}, Qubit{arg2}, Qubit{arg3});
 }
 void QIREE_QIS_FUNCTION(cnot, body)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->cnot(Qubit{arg1}, Qubit{arg2});
+    return quantum().cnot(Qubit{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(cx, body)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->cx(Qubit{arg1}, Qubit{arg2});
+    return quantum().cx(Qubit{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(cy, body)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->cy(Qubit{arg1}, Qubit{arg2});
+    return quantum().cy(Qubit{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(cz, body)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->cz(Qubit{arg1}, Qubit{arg2});
+    return quantum().cz(Qubit{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(exp, adj)(std::uintptr_t arg1,
                                   double arg2,
                                   std::uintptr_t arg3)
 {
-    return q_interface_->exp_adj(Array{arg1}, arg2, Array{arg3});
+    return quantum().exp_adj(Array{arg1}, arg2, Array{arg3});
 }
 void QIREE_QIS_FUNCTION(exp, body)(std::uintptr_t arg1,
                                    double arg2,
                                    std::uintptr_t arg3)
 {
-    return q_interface_->exp(Array{arg1}, arg2, Array{arg3});
+    return quantum().exp(Array{arg1}, arg2, Array{arg3});
 }
 void QIREE_QIS_FUNCTION(exp, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->exp(Array{arg1}, Tuple{arg2});
+    return quantum().exp(Array{arg1}, Tuple{arg2});
 }
 void QIREE_QIS_FUNCTION(exp, ctladj)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->exp_adj(Array{arg1}, Tuple{arg2});
+    return quantum().exp_adj(Array{arg1}, Tuple{arg2});
 }
 void QIREE_QIS_FUNCTION(h, body)(std::uintptr_t arg1)
 {
-    return q_interface_->h(Qubit{arg1});
+    return quantum().h(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(h, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->h(Array{arg1}, Qubit{arg2});
+    return quantum().h(Array{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(r,
                         adj)(pauli_type arg1, double arg2, std::uintptr_t arg3)
 {
-    return q_interface_->r_adj(static_cast<Pauli>(arg1), arg2, Qubit{arg3});
+    return quantum().r_adj(static_cast<Pauli>(arg1), arg2, Qubit{arg3});
 }
 void QIREE_QIS_FUNCTION(r,
                         body)(pauli_type arg1, double arg2, std::uintptr_t arg3)
 {
-    return q_interface_->r(static_cast<Pauli>(arg1), arg2, Qubit{arg3});
+    return quantum().r(static_cast<Pauli>(arg1), arg2, Qubit{arg3});
 }
 void QIREE_QIS_FUNCTION(r, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->r(Array{arg1}, Tuple{arg2});
+    return quantum().r(Array{arg1}, Tuple{arg2});
 }
 void QIREE_QIS_FUNCTION(r, ctladj)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->r_adj(Array{arg1}, Tuple{arg2});
+    return quantum().r_adj(Array{arg1}, Tuple{arg2});
 }
 void QIREE_QIS_FUNCTION(reset, body)(std::uintptr_t arg1)
 {
-    return q_interface_->reset(Qubit{arg1});
+    return quantum().reset(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(rx, body)(double arg1, std::uintptr_t arg2)
 {
-    return q_interface_->rx(arg1, Qubit{arg2});
+    return quantum().rx(arg1, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(rx, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->rx(Array{arg1}, Tuple{arg2});
+    return quantum().rx(Array{arg1}, Tuple{arg2});
 }
 void QIREE_QIS_FUNCTION(rxx, body)(double arg1,
                                    std::uintptr_t arg2,
                                    std::uintptr_t arg3)
 {
-    return q_interface_->rxx(arg1, Qubit{arg2}, Qubit{arg3});
+    return quantum().rxx(arg1, Qubit{arg2}, Qubit{arg3});
 }
 void QIREE_QIS_FUNCTION(ry, body)(double arg1, std::uintptr_t arg2)
 {
-    return q_interface_->ry(arg1, Qubit{arg2});
+    return quantum().ry(arg1, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(ry, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->ry(Array{arg1}, Tuple{arg2});
+    return quantum().ry(Array{arg1}, Tuple{arg2});
 }
 void QIREE_QIS_FUNCTION(ryy, body)(double arg1,
                                    std::uintptr_t arg2,
                                    std::uintptr_t arg3)
 {
-    return q_interface_->ryy(arg1, Qubit{arg2}, Qubit{arg3});
+    return quantum().ryy(arg1, Qubit{arg2}, Qubit{arg3});
 }
 void QIREE_QIS_FUNCTION(rz, body)(double arg1, std::uintptr_t arg2)
 {
-    return q_interface_->rz(arg1, Qubit{arg2});
+    return quantum().rz(arg1, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(rz, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->rz(Array{arg1}, Tuple{arg2});
+    return quantum().rz(Array{arg1}, Tuple{arg2});
 }
 void QIREE_QIS_FUNCTION(rzz, body)(double arg1,
                                    std::uintptr_t arg2,
                                    std::uintptr_t arg3)
 {
-    return q_interface_->rzz(arg1, Qubit{arg2}, Qubit{arg3});
+    return quantum().rzz(arg1, Qubit{arg2}, Qubit{arg3});
 }
 void QIREE_QIS_FUNCTION(s, adj)(std::uintptr_t arg1)
 {
-    return q_interface_->s_adj(Qubit{arg1});
+    return quantum().s_adj(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(s, body)(std::uintptr_t arg1)
 {
-    return q_interface_->s(Qubit{arg1});
+    return quantum().s(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(s, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->s(Array{arg1}, Qubit{arg2});
+    return quantum().s(Array{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(s, ctladj)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->s_adj(Array{arg1}, Qubit{arg2});
+    return quantum().s_adj(Array{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(swap, body)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->swap(Qubit{arg1}, Qubit{arg2});
+    return quantum().swap(Qubit{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(t, adj)(std::uintptr_t arg1)
 {
-    return q_interface_->t_adj(Qubit{arg1});
+    return quantum().t_adj(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(t, body)(std::uintptr_t arg1)
 {
-    return q_interface_->t(Qubit{arg1});
+    return quantum().t(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(t, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->t(Array{arg1}, Qubit{arg2});
+    return quantum().t(Array{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(t, ctladj)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->t_adj(Array{arg1}, Qubit{arg2});
+    return quantum().t_adj(Array{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(x, body)(std::uintptr_t arg1)
 {
-    return q_interface_->x(Qubit{arg1});
+    return quantum().x(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(x, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->x(Array{arg1}, Qubit{arg2});
+    return quantum().x(Array{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(y, body)(std::uintptr_t arg1)
 {
-    return q_interface_->y(Qubit{arg1});
+    return quantum().y(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(y, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->y(Array{arg1}, Qubit{arg2});
+    return quantum().y(Array{arg1}, Qubit{arg2});
 }
 void QIREE_QIS_FUNCTION(z, body)(std::uintptr_t arg1)
 {
-    return q_interface_->z(Qubit{arg1});
+    return quantum().z(Qubit{arg1});
 }
 void QIREE_QIS_FUNCTION(z, ctl)(std::uintptr_t arg1, std::uintptr_t arg2)
 {
-    return q_interface_->z(Array{arg1}, Qubit{arg2});
+    return quantum().z(Array{arg1}, Qubit{arg2});
 }
 //---------------------------------------------------------------------------//
 // ASSERTIONS
@@ -262,13 +340,13 @@ void QIREE_QIS_FUNCTION(assertmeasurementprobability,
                               std::uintptr_t arg5,
                               double arg6)
 {
-    return q_interface_->assertmeasurementprobability(
+    return quantum().assertmeasurementprobability(
         Array{arg1}, Array{arg2}, Result{arg3}, arg4, String{arg5}, arg6);
 }
 void QIREE_QIS_FUNCTION(assertmeasurementprobability, ctl)(std::uintptr_t arg1,
                                                            std::uintptr_t arg2)
 {
-    return q_interface_->assertmeasurementprobability(Array{arg1}, Tuple{arg2});
+    return quantum().assertmeasurementprobability(Array{arg1}, Tuple{arg2});
 }
 
 //---------------------------------------------------------------------------//
@@ -276,74 +354,189 @@ void QIREE_QIS_FUNCTION(assertmeasurementprobability, ctl)(std::uintptr_t arg1,
 //---------------------------------------------------------------------------//
 void QIREE_RT_FUNCTION(initialize)(OptionalCString env)
 {
-    return r_interface_->initialize(env);
+    return runtime().initialize(env);
 }
 void QIREE_RT_FUNCTION(array_record_output)(size_type s, OptionalCString tag)
 {
-    return r_interface_->array_record_output(s, tag);
+    return runtime().array_record_output(s, tag);
 }
 void QIREE_RT_FUNCTION(tuple_record_output)(size_type s, OptionalCString tag)
 {
-    return r_interface_->tuple_record_output(s, tag);
+    return runtime().tuple_record_output(s, tag);
 }
 void QIREE_RT_FUNCTION(result_record_output)(std::uintptr_t r,
                                              OptionalCString tag)
 {
-    return r_interface_->result_record_output(Result{r}, tag);
+    return runtime().result_record_output(Result{r}, tag);
 }
 
 //!@}
+//---------------------------------------------------------------------------//
+/*!
+ * Get the value of an LLVM result or throw.
+ */
+template<class T>
+T unwrap(llvm::Expected<T> value, char const* context)
+{
+    QIREE_VALIDATE(value,
+                   << context << ": " << llvm::toString(value.takeError()));
+    return std::move(*value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Throw if an LLVM operation failed.
+ */
+void check(llvm::Error err, char const* context)
+{
+    if (err)
+    {
+        QIREE_VALIDATE(false,
+                       << context << ": " << llvm::toString(std::move(err)));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Called in place of a function that the JIT failed to compile.
+ */
+void lazy_compile_failure()
+{
+    QIREE_VALIDATE(false,
+                   << "failed to compile a QIR function (see LLVM "
+                      "diagnostics)");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Copy a module into a new context via bitcode.
+ */
+llvm::orc::ThreadSafeModule copy_to_new_context(llvm::Module const& mod)
+{
+    llvm::SmallVector<char, 0> bitcode;
+    llvm::raw_svector_ostream os{bitcode};
+    llvm::WriteBitcodeToFile(mod, os);
+
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto result = unwrap(
+        llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef{llvm::StringRef{bitcode.data(),
+                                                  bitcode.size()},
+                                  mod.getModuleIdentifier()},
+            *context),
+        "failed to copy LLVM module");
+    return {std::move(result), std::move(context)};
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace
 
 //---------------------------------------------------------------------------//
 /*!
- * Construct with a QIR input filename.
+ * Construct with a QIR module.
  */
-Executor::Executor(Module&& module)
-    : entrypoint_{module.entrypoint_}, module_{module.module_.get()}
+Executor::Executor(Module&& module) : Executor{std::move(module), Options{}}
 {
-    QIREE_EXPECT(module);
-    QIREE_EXPECT(entrypoint_ && module_);
+}
 
-    // Save module and entry point attributes
-    entry_point_attrs_ = module.load_entry_point_attrs();
-    module_flags_ = module.load_module_flags();
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a QIR module and options.
+ */
+Executor::Executor(Module&& module, Options const& opts)
+{
+    QIREE_EXPECT(module);
+    QIREE_EXPECT(module.entrypoint_ && module.module_);
 
     // Initialize LLVM
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
-    LLVMLinkInMCJIT();
 
-    // Create execution engine by capturing the module
-    ee_ = [&module] {
-        llvm::EngineBuilder builder{std::move(module.module_)};
+    // Compile for the host, allowing exceptions from the interfaces to
+    // propagate through compiled code
+    auto target = unwrap(llvm::orc::JITTargetMachineBuilder::detectHost(),
+                         "failed to detect host target");
+    target.getOptions().ExceptionModel = llvm::ExceptionHandling::DwarfCFI;
+
+    // Optimize for the host before analysis so that inlined functions and
+    // unrolled loops are seen as straight-line code
+    {
+        auto const start = std::chrono::steady_clock::now();
+        auto tm = unwrap(target.createTargetMachine(),
+                         "failed to create host target machine");
+        module.optimize(opts.opt_level, tm.get());
+        optimize_time_ = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    }
+
+    // Save module and entry point attributes
+    entry_point_attrs_ = module.load_entry_point_attrs();
+    if (opts.hash_module)
+    {
+        entry_point_attrs_.module_hash = module.content_hash();
+    }
+    module_flags_ = module.load_module_flags();
+    analysis_ = module.analyze();
+
+    // Replace calls to simple operations with writes to a buffer
+    if (opts.direct_runtime)
+    {
+        detail::define_direct_runtime(*module.module_);
+        direct_runtime_ = true;
+    }
 
-        // Pass a reference to a string for diagnosing errors
-        std::string err_str;
-        builder.setErrorStr(&err_str);
+    std::string const entry_name = module.entrypoint_->getName().str();
+    QIREE_VALIDATE(module.entrypoint_->arg_empty(),
+                   << "entry point '" << entry_name
+                   << "' cannot take arguments");
 
-        // Set execution options
-        llvm::TargetOptions opts;
-        opts.ExceptionModel = llvm::ExceptionHandling::DwarfCFI;
-        builder.setTargetOptions(opts);
+    // Reuse machine code compiled for the same module and target
+    if (!opts.object_cache_dir.empty() && !module.content_hash().empty())
+    {
+        object_cache_ = std::make_unique<detail::JitObjectCache>(
+            opts.object_cache_dir,
+            module.content_hash() + '-' + to_cstring(opts.opt_level)
+                + (opts.direct_runtime ? "-direct" : ""),
+            target);
+    }
 
-        // Create the builder, or throw an exception with the failure
-        std::unique_ptr<llvm::ExecutionEngine> ee{builder.create()};
-        QIREE_VALIDATE(ee, << "failed to create execution engine: " << err_str);
-        return ee;
+    // Create a lazy JIT that compiles functions on a thread pool
+    unsigned int num_threads = opts.num_compile_threads;
+    if (num_threads == 0)
+    {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    jit_ = [&] {
+        using llvm::orc::IRCompileLayer;
+        llvm::orc::LLLazyJITBuilder builder;
+        builder.setJITTargetMachineBuilder(target);
+        builder.setNumCompileThreads(num_threads);
+#if LLVM_VERSION_MAJOR >= 16
+        builder.setLazyCompileFailureAddr(
+            llvm::orc::ExecutorAddr::fromPtr(&lazy_compile_failure));
+#else
+        builder.setLazyCompileFailureAddr(
+            llvm::pointerToJITTargetAddress(&lazy_compile_failure));
+#endif
+        builder.setCompileFunctionCreator(
+            [cache = object_cache_.get()](
+                llvm::orc::JITTargetMachineBuilder jtmb)
+                -> llvm::Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+                return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+                    std::move(jtmb), cache);
+            });
+        return unwrap(builder.create(), "failed to create JIT");
     }();
 
-    // Suppress symbol lookup in system dynamic libraries
-    ee_->DisableSymbolSearching(true);
-
-    // Add "lazy function creator" that just gives a more informative message
-    ee_->InstallLazyFunctionCreator([](std::string const& s) -> void* {
-        QIREE_NOT_IMPLEMENTED(s.c_str());
-    });
+    llvm::Module& mod = *module.module_;
+    mod.setDataLayout(jit_->getDataLayout());
 
     // Bind functions if available
-    detail::GlobalMapper bind_function(*module_, ee_.get());
+    llvm::orc::SymbolMap symbols;
+    llvm::orc::MangleAndInterner mangle{jit_->getExecutionSession(),
+                                        jit_->getDataLayout()};
+    detail::GlobalMapper bind_function(mod, mangle, symbols);
 #define QIREE_BIND_RT_FUNCTION(FUNC) \
     bind_function("__quantum__rt__" #FUNC, QIREE_RT_FUNCTION(FUNC))
 #define QIREE_BIND_QIS_FUNCTION(FUNC, SUFFIX)            \
@@ -404,9 +597,49 @@ Executor::Executor(Module&& module)
     QIREE_BIND_RT_FUNCTION(array_record_output);
     QIREE_BIND_RT_FUNCTION(tuple_record_output);
     QIREE_BIND_RT_FUNCTION(result_record_output);
+    // Direct runtime
+    bind_function(detail::direct_buffer_name, direct_buffer);
+    bind_function(detail::direct_flush_name, direct_flush);
 #undef QIREE_BIND_RT_FUNCTION
 #undef QIREE_BIND_QIS_FUNCTION
 
+    // Check that every external function called by the module is bound
+    for (llvm::Function const& f : mod)
+    {
+        if (f.isDeclaration() && !f.isIntrinsic() && !f.use_empty()
+            && !symbols.count(mangle(f.getName())))
+        {
+            QIREE_NOT_IMPLEMENTED(f.getName().str().c_str());
+        }
+    }
+    check(jit_->getMainJITDylib().define(
+              llvm::orc::absoluteSymbols(std::move(symbols))),
+          "failed to define QIR functions");
+
+    // Hand the module to the JIT, copying it if its context is not owned
+    llvm::orc::ThreadSafeModule tsm;
+    if (module.context_)
+    {
+        tsm = {std::move(module.module_), std::move(module.context_)};
+    }
+    else
+    {
+        tsm = copy_to_new_context(mod);
+        module.module_.reset();
+    }
+    module.entrypoint_ = nullptr;
+    check(jit_->addLazyIRModule(std::move(tsm)), "failed to add QIR module");
+
+    // Look up the entry point, which compiles only a stub
+    auto entry = unwrap(jit_->lookup(entry_name),
+                        "failed to find QIR entry point");
+#if LLVM_VERSION_MAJOR >= 15
+    entrypoint_ = entry.toPtr<EntryFunction>();
+#else
+    entrypoint_
+        = llvm::jitTargetAddressToFunction<EntryFunction>(entry.getAddress());
+#endif
+
     QIREE_ENSURE(!module);
 }
 
@@ -417,28 +650,48 @@ Executor::~Executor() = default;
 //---------------------------------------------------------------------------//
 /*!
  * Execute with the given interface functions.
+ *
+ * This may be called simultaneously from multiple threads as long as each
+ * thread uses its own distinct interfaces. It may not be called recursively
+ * (i.e., from inside one of the interface functions).
  */
 void Executor::operator()(QuantumInterface& qi, RuntimeInterface& ri) const
 {
-    QIREE_EXPECT(ee_);
+    QIREE_EXPECT(entrypoint_);
 
     QIREE_VALIDATE(!q_interface_ && !r_interface_,
-                   << "cannot call LLVM executor recursively or in MT "
-                      "environment (for now)");
+                   << "cannot call LLVM executor recursively");
     detail::EndGuard on_end_scope_([] {
+        direct_buffer_ = {};
         q_interface_->tear_down();
         q_interface_ = nullptr;
         r_interface_ = nullptr;
     });
     q_interface_ = &qi;
     r_interface_ = &ri;
+    if (direct_runtime_)
+    {
+        direct_ops_.resize(direct_capacity);
+        OpTape::Op* const begin = direct_ops_.data();
+        direct_buffer_ = {begin, begin + direct_ops_.size(), begin};
+    }
 
     // Call setup on the interface
     qi.set_up(entry_point_attrs_);
 
     // Execute the main function
-    auto result = ee_->runFunction(entrypoint_, {});
-    QIREE_DISCARD(result);
+    entrypoint_();
+    direct_flush();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether all code compiled so far was loaded from the object cache.
+ */
+bool Executor::object_from_cache() const
+{
+    return object_cache_ && object_cache_->num_loaded() > 0
+           && object_cache_->num_compiled() == 0;
 }
 
 //---------------------------------------------------------------------------//
@@ -11,47 +11,116 @@
 #include <string>
 
 #include "Macros.hh"
+#include "Module.hh"
 #include "Types.hh"
 
 namespace llvm
 {
-class Module;
-class ExecutionEngine;
-class Function;
+namespace orc
+{
+class LLLazyJIT;
+}
 }  // namespace llvm
 
 namespace qiree
 {
 //---------------------------------------------------------------------------//
-class Module;
 class QuantumInterface;
 class RuntimeInterface;
+namespace detail
+{
+class JitObjectCache;
+}
 
 //---------------------------------------------------------------------------//
 /*!
- * Set up and run an LLVM Execution Engine that wraps QIR.
+ * Set up and run an LLVM ORC JIT that wraps QIR.
+ *
+ * The module is handed to a lazy JIT at construction: each function is
+ * compiled the first time it is called, on a pool of compile threads, so a
+ * program starts running before all of its functions have been compiled.
+ * The QIS and runtime functions implemented by QIR-EE are defined as absolute
+ * symbols in the JIT's main library; construction fails if the module calls
+ * any other external function.
+ *
+ * Multiple threads can execute the program concurrently, provided each thread
+ * passes its own quantum and runtime interfaces.
+ *
+ * Before compilation, the module can be optimized with an LLVM pass pipeline
+ * (see \c Module::optimize ). Higher levels reduce the classical overhead of
+ * each shot at the cost of a slower start; the time spent is reported by
+ * \c optimize_time .
+ *
+ * With the direct runtime, calls to gates, measurements into results, and
+ * output recording are replaced by inlined writes to a per-thread buffer of
+ * operations, which is applied to the interfaces when it fills, before any
+ * other interface function is called, and when the program ends. This
+ * removes a call and a virtual call per operation from the compiled code.
+ *
+ * If an object cache directory is given and the module was loaded from a file
+ * or bytes (so that its content hash is known), the compiled machine code is
+ * saved there. Later executors for the same module and host load the objects
+ * instead of running code generation.
  */
 class Executor
 {
   public:
-    // Construct with a QIR input filename and function name
+    //! Compilation options
+    struct Options
+    {
+        //! Directory of cached compiled objects (empty to disable)
+        std::string object_cache_dir;
+        //! Number of threads that compile functions (zero for all cores)
+        unsigned int num_compile_threads{0};
+        //! IR optimization pipeline run before compilation
+        Module::OptLevel opt_level{Module::OptLevel::O0};
+        //! Buffer simple operations in compiled code
+        bool direct_runtime{false};
+        //! Pass the module hash to interfaces that cache circuits
+        bool hash_module{false};
+    };
+
+  public:
+    // Construct with a QIR module
     explicit Executor(Module&& module);
 
+    // Construct with a QIR module and options
+    Executor(Module&& module, Options const& opts);
+
     // Default destructor
     ~Executor();
 
     QIREE_DELETE_COPY_MOVE(Executor);
 
-    // Execute with the given interface functions
+    // Execute with the given interface functions (thread safe)
     void operator()(QuantumInterface& qi, RuntimeInterface& ri) const;
 
+    //! Entry point attributes of the compiled program
+    EntryPointAttrs const& entry_point_attrs() const
+    {
+        return entry_point_attrs_;
+    }
+
+    //! Static analysis of the compiled program
+    ModuleAnalysis const& analysis() const { return analysis_; }
+
+    // Whether all code compiled so far was loaded from the object cache
+    bool object_from_cache() const;
+
+    //! Time spent optimizing the IR [s]
+    double optimize_time() const { return optimize_time_; }
+
   private:
-    llvm::Function* entrypoint_{nullptr};
-    llvm::Module* module_{nullptr};
+    using EntryFunction = void (*)();
 
     EntryPointAttrs entry_point_attrs_;
     ModuleFlags module_flags_;
-    std::unique_ptr<llvm::ExecutionEngine> ee_;
+    ModuleAnalysis analysis_;
+    double optimize_time_{0};
+    bool direct_runtime_{false};
+    std::unique_ptr<detail::JitObjectCache> object_cache_;
+    std::unique_ptr<llvm::orc::LLLazyJIT> jit_;
+    EntryFunction entrypoint_{nullptr};
 };
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,396 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ExternalDistribution.cc
+//---------------------------------------------------------------------------//
+#include "ExternalDistribution.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <queue>
+
+#include "Assert.hh"
+#include "RecordedResult.hh"
+#include "detail/MappedFile.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Number of 64-bit words needed to store a packed key.
+ */
+std::size_t num_words_for(std::size_t num_bits)
+{
+    return std::max<std::size_t>(1, (num_bits + 63) / 64);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Position in a sorted run during a merge.
+ */
+struct Cursor
+{
+    std::uint64_t const* pos;
+    std::uint64_t const* end;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a scratch file and a memory limit.
+ *
+ * The file is created (or truncated) immediately. The memory limit applies to
+ * the counts held before spilling; queries additionally hold a sorted copy of
+ * those counts.
+ */
+ExternalDistribution::ExternalDistribution(std::string filename,
+                                           size_type max_memory_bytes)
+    : filename_{std::move(filename)}
+    , out_{filename_, std::ios::out | std::ios::binary | std::ios::trunc}
+    , max_memory_bytes_{max_memory_bytes}
+{
+    QIREE_VALIDATE(out_,
+                   << "failed to open distribution scratch file '"
+                   << filename_ << "'");
+    this->set_num_bits(0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Delete the scratch file.
+ */
+ExternalDistribution::~ExternalDistribution()
+{
+    out_.close();
+    std::remove(filename_.c_str());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Accumulate the results of a single shot.
+ */
+void ExternalDistribution::accumulate(RecordedResult const& result)
+{
+    auto const& bits = result.bits();
+    this->set_num_bits(bits.size());
+
+    packed_.assign(num_words_, 0);
+    for (size_type i = 0; i < bits.size(); ++i)
+    {
+        if (bits[i])
+        {
+            packed_[i / 64] |= (Word{1} << (i % 64));
+        }
+    }
+    this->add_packed(packed_.data(), 1);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add the counts from an in-memory distribution.
+ *
+ * This allows shots to be run in batches whose distributions are merged and
+ * discarded.
+ */
+void ExternalDistribution::merge(ResultDistribution const& other)
+{
+    if (other.size() == 0)
+    {
+        return;
+    }
+    this->set_num_bits(other.num_bits());
+    other.for_each_packed([this](Word const* key, size_type count) {
+        this->add_packed(key, count);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write the counts in memory to a new run.
+ *
+ * This is called automatically when the in-memory counts reach the memory
+ * limit.
+ */
+void ExternalDistribution::spill()
+{
+    if (counts_.empty())
+    {
+        return;
+    }
+
+    auto records = this->sorted_records();
+    out_.write(reinterpret_cast<char const*>(records.data()),
+               static_cast<std::streamsize>(records.size() * sizeof(Word)));
+    out_.flush();
+    QIREE_VALIDATE(out_,
+                   << "failed to write distribution run to '" << filename_
+                   << "'");
+
+    runs_.push_back({file_words_, counts_.size()});
+    file_words_ += records.size();
+    counts_ = detail::PackedCountMap{num_words_};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Call visit(Word const* key, size_type count) for each distinct key.
+ *
+ * Keys are visited once each in increasing order of their packed words, with
+ * the counts from all runs and from memory combined.
+ */
+void ExternalDistribution::for_each_packed(VisitPacked const& visit) const
+{
+    size_type const nw = num_words_;
+    size_type const rw = this->record_words();
+
+    detail::MappedFile mapped;
+    if (!runs_.empty())
+    {
+        mapped = detail::MappedFile{filename_};
+        QIREE_ASSERT(mapped.size() == file_words_ * sizeof(Word));
+    }
+    auto const* file_words = reinterpret_cast<Word const*>(mapped.data());
+    auto const memory_run = this->sorted_records();
+
+    std::vector<Cursor> cursors;
+    cursors.reserve(runs_.size() + 1);
+    for (Run const& run : runs_)
+    {
+        Word const* start = file_words + run.offset;
+        cursors.push_back({start, start + run.num_records * rw});
+    }
+    if (!memory_run.empty())
+    {
+        cursors.push_back(
+            {memory_run.data(), memory_run.data() + memory_run.size()});
+    }
+
+    // Min-heap of cursor indices ordered by their current key
+    auto key_greater = [&cursors, nw](size_type a, size_type b) {
+        Word const* ka = cursors[a].pos;
+        Word const* kb = cursors[b].pos;
+        return std::lexicographical_compare(kb, kb + nw, ka, ka + nw);
+    };
+    using VecIndex = std::vector<size_type>;
+    std::priority_queue<size_type, VecIndex, decltype(key_greater)> heap{
+        key_greater};
+    for (size_type i = 0; i < cursors.size(); ++i)
+    {
+        heap.push(i);
+    }
+
+    std::vector<Word> key(nw);
+    while (!heap.empty())
+    {
+        // Combine the counts of every run at the smallest key
+        Word const* first = cursors[heap.top()].pos;
+        std::copy(first, first + nw, key.begin());
+        size_type count = 0;
+        while (!heap.empty()
+               && std::equal(key.begin(), key.end(), cursors[heap.top()].pos))
+        {
+            size_type i = heap.top();
+            heap.pop();
+            count += cursors[i].pos[nw];
+            cursors[i].pos += rw;
+            if (cursors[i].pos != cursors[i].end)
+            {
+                heap.push(i);
+            }
+        }
+        visit(key.data(), count);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the most frequent bit strings in descending order of count.
+ *
+ * Keys with equal counts are ordered by their packed words.
+ */
+auto ExternalDistribution::top(size_type k) const -> VecCount
+{
+    using Entry = std::pair<size_type, std::vector<Word>>;
+    auto more_frequent = [](Entry const& a, Entry const& b) {
+        if (a.first != b.first)
+        {
+            return a.first > b.first;
+        }
+        return a.second < b.second;
+    };
+
+    // Keep the best k entries seen so far, with the worst at the top
+    std::priority_queue<Entry, std::vector<Entry>, decltype(more_frequent)>
+        best{more_frequent};
+    if (k > 0)
+    {
+        this->for_each_packed([&](Word const* key, size_type count) {
+            if (best.size() == k && count <= best.top().first)
+            {
+                return;
+            }
+            best.emplace(count, std::vector<Word>(key, key + num_words_));
+            if (best.size() > k)
+            {
+                best.pop();
+            }
+        });
+    }
+
+    VecCount result(best.size());
+    for (auto iter = result.rbegin(); iter != result.rend(); ++iter)
+    {
+        auto const& [count, key] = best.top();
+        *iter = {this->to_string(key.data()), count};
+        best.pop();
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the distribution of a subset of the bits.
+ *
+ * Each key of the result has one character per index, in the order given.
+ * At most 64 bits can be selected.
+ */
+auto ExternalDistribution::marginal(std::vector<size_type> const& indices) const
+    -> MapCount
+{
+    QIREE_VALIDATE(indices.size() <= 64,
+                   << "cannot compute marginal distribution of "
+                   << indices.size() << " bits (at most 64 are allowed)");
+    for (auto i : indices)
+    {
+        QIREE_VALIDATE(i < num_bits_,
+                       << "marginal bit index " << i
+                       << " is out of range for " << num_bits_
+                       << "-bit results");
+    }
+
+    // Accumulate by packed marginal bits
+    std::map<Word, size_type> packed_counts;
+    this->for_each_packed([&](Word const* key, size_type count) {
+        Word m = 0;
+        for (size_type j = 0; j < indices.size(); ++j)
+        {
+            auto i = indices[j];
+            m |= ((key[i / 64] >> (i % 64)) & 1) << j;
+        }
+        packed_counts[m] += count;
+    });
+
+    MapCount result;
+    for (auto const& [m, count] : packed_counts)
+    {
+        std::string bits(indices.size(), '0');
+        for (size_type j = 0; j < indices.size(); ++j)
+        {
+            if ((m >> j) & 1)
+            {
+                bits[j] = '1';
+            }
+        }
+        result.emplace(std::move(bits), count);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Convert a packed key to a bit string ("0" for false, "1" for true).
+ */
+std::string ExternalDistribution::to_string(Word const* key) const
+{
+    std::string result(num_bits_, '0');
+    for (size_type i = 0; i < num_bits_; ++i)
+    {
+        if ((key[i / 64] >> (i % 64)) & 1)
+        {
+            result[i] = '1';
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Set the number of bits on the first result or check it on later ones.
+ */
+void ExternalDistribution::set_num_bits(size_type num_bits)
+{
+    if (num_shots_ > 0)
+    {
+        QIREE_VALIDATE(num_bits == num_bits_,
+                       << "result bit length " << num_bits
+                       << " does not match distribution key length "
+                       << num_bits_);
+        return;
+    }
+    num_bits_ = num_bits;
+    num_words_ = num_words_for(num_bits);
+    counts_ = detail::PackedCountMap{num_words_};
+
+    // The hash table is at most half full and stores a key and a count per
+    // slot
+    max_entries_ = std::max<size_type>(
+        1, max_memory_bytes_ / (2 * sizeof(Word) * this->record_words()));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add to the count of a packed key, spilling if memory is full.
+ */
+void ExternalDistribution::add_packed(Word const* key, size_type count)
+{
+    counts_.add(key, count);
+    num_shots_ += count;
+    if (counts_.size() >= max_entries_)
+    {
+        this->spill();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Copy the in-memory counts as records sorted by key.
+ */
+std::vector<ExternalDistribution::Word>
+ExternalDistribution::sorted_records() const
+{
+    size_type const nw = num_words_;
+    std::vector<size_type> slots;
+    slots.reserve(counts_.size());
+    for (size_type slot = 0; slot != counts_.capacity(); ++slot)
+    {
+        if (counts_.count_at(slot) != 0)
+        {
+            slots.push_back(slot);
+        }
+    }
+    auto key_less = [this, nw](size_type a, size_type b) {
+        Word const* ka = counts_.key_at(a);
+        Word const* kb = counts_.key_at(b);
+        return std::lexicographical_compare(ka, ka + nw, kb, kb + nw);
+    };
+    std::sort(slots.begin(), slots.end(), key_less);
+
+    std::vector<Word> records;
+    records.reserve(slots.size() * this->record_words());
+    for (size_type slot : slots)
+    {
+        Word const* key = counts_.key_at(slot);
+        records.insert(records.end(), key, key + nw);
+        records.push_back(counts_.count_at(slot));
+    }
+    return records;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,137 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ExternalDistribution.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Macros.hh"
+#include "ResultDistribution.hh"
+#include "detail/PackedCountMap.hh"
+
+namespace qiree
+{
+class RecordedResult;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Distribution of recorded results that spills to disk.
+ *
+ * Programs with many results can produce a distinct bit string on nearly
+ * every shot, so an in-memory \c ResultDistribution grows with the number of
+ * shots. This distribution accumulates counts in memory until they reach a
+ * limit, then sorts them by packed key and appends them as a \em run to a
+ * scratch file. Queries map the file into memory and merge the runs (and the
+ * counts still in memory) in a single sequential pass, so only one record per
+ * run is resident at a time.
+ *
+ * Keys are packed as in \c ResultDistribution . Each record of a run is the
+ * key's words followed by its count, all native 64-bit integers. The scratch
+ * file is deleted when the distribution is destroyed.
+ *
+ * \code
+   ExternalDistribution dist{"/scratch/shots.runs"};
+   for (size_type i = 0; i < num_batches; ++i)
+   {
+       dist.merge(run_shots(batch_size));
+   }
+   for (auto const& [bits, count] : dist.top(10)) { ... }
+ * \endcode
+ */
+class ExternalDistribution
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Word = ResultDistribution::Word;
+    using size_type = ResultDistribution::size_type;
+    using VecCount = std::vector<std::pair<std::string, size_type>>;
+    using MapCount = std::map<std::string, size_type>;
+    using VisitPacked = std::function<void(Word const*, size_type)>;
+    //!@}
+
+    //! Default maximum memory for counts before spilling
+    static constexpr size_type default_max_memory_bytes = size_type(256)
+                                                          << 20;
+
+  public:
+    // Construct with a scratch file and a memory limit
+    explicit ExternalDistribution(
+        std::string filename,
+        size_type max_memory_bytes = default_max_memory_bytes);
+
+    // Delete the scratch file
+    ~ExternalDistribution();
+
+    //! Prevent copying
+    QIREE_DELETE_COPY_MOVE(ExternalDistribution);
+
+    // Accumulate the results of a single shot
+    void accumulate(RecordedResult const& result);
+
+    // Add the counts from an in-memory distribution
+    void merge(ResultDistribution const& other);
+
+    // Write the counts in memory to a new run
+    void spill();
+
+    // Call visit(Word const* key, size_type count) for each distinct key
+    void for_each_packed(VisitPacked const& visit) const;
+
+    // Get the most frequent bit strings in descending order of count
+    VecCount top(size_type k) const;
+
+    // Get the distribution of a subset of the bits
+    MapCount marginal(std::vector<size_type> const& indices) const;
+
+    // Convert a packed key to a bit string
+    std::string to_string(Word const* key) const;
+
+    //! Number of bits in each key (zero before accumulating)
+    size_type num_bits() const { return num_bits_; }
+
+    //! Total number of shots accumulated
+    size_type num_shots() const { return num_shots_; }
+
+    //! Number of runs written to disk
+    size_type num_runs() const { return runs_.size(); }
+
+  private:
+    //! Location of a sorted run in the scratch file
+    struct Run
+    {
+        size_type offset;  //!< Start of the run in words
+        size_type num_records;
+    };
+
+    std::string filename_;
+    std::ofstream out_;
+    size_type max_memory_bytes_;
+    size_type max_entries_{0};
+    size_type num_bits_{0};
+    size_type num_words_{1};
+    size_type num_shots_{0};
+    size_type file_words_{0};
+    detail::PackedCountMap counts_;
+    std::vector<Run> runs_;
+    std::vector<Word> packed_;
+
+    //// HELPER FUNCTIONS ////
+
+    void set_num_bits(size_type num_bits);
+    void add_packed(Word const* key, size_type count);
+    std::vector<Word> sorted_records() const;
+    size_type record_words() const { return num_words_ + 1; }
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,288 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/JsonConfig.cc
+//---------------------------------------------------------------------------//
+#include "JsonConfig.hh"
+
+#include <cctype>
+#include <cstddef>
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Append a Unicode code point as UTF-8.
+ */
+void append_utf8(unsigned long cp, std::string& s)
+{
+    if (cp < 0x80)
+    {
+        s += static_cast<char>(cp);
+    }
+    else if (cp < 0x800)
+    {
+        s += static_cast<char>(0xc0 | (cp >> 6));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+    else if (cp < 0x10000)
+    {
+        s += static_cast<char>(0xe0 | (cp >> 12));
+        s += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+    else
+    {
+        s += static_cast<char>(0xf0 | (cp >> 18));
+        s += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+        s += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Parse a flat JSON object into key/value strings.
+ *
+ * The input must be a valid JSON object whose values are strings, numbers,
+ * or booleans: nested objects, arrays, and \c null are rejected. The value of
+ * a string is stored unquoted and unescaped; numbers and booleans are stored
+ * verbatim, to be converted by \c set_option like any other string.
+ */
+ConfigItems parse_json_config(std::string_view json)
+{
+    std::size_t pos = 0;
+    auto fail = [&pos](char const* what) {
+        QIREE_VALIDATE(false,
+                       << "invalid JSON configuration: " << what
+                       << " at position " << pos);
+    };
+    auto skip_space = [&json, &pos] {
+        while (pos < json.size()
+               && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n'
+                   || json[pos] == '\r'))
+        {
+            ++pos;
+        }
+    };
+    auto peek = [&json, &pos, &skip_space] {
+        skip_space();
+        return pos < json.size() ? json[pos] : '\0';
+    };
+    auto expect = [&pos, &peek, &fail](char c) {
+        if (peek() != c)
+        {
+            std::string what{"expected '"};
+            what += c;
+            what += '\'';
+            fail(what.c_str());
+        }
+        ++pos;
+    };
+    auto is_digit = [&json, &pos] {
+        return pos < json.size()
+               && std::isdigit(static_cast<unsigned char>(json[pos]));
+    };
+    auto read_hex4 = [&json, &pos, &fail] {
+        unsigned long result = 0;
+        for (int i = 0; i < 4; ++i, ++pos)
+        {
+            char c = pos < json.size() ? json[pos] : '\0';
+            if (!std::isxdigit(static_cast<unsigned char>(c)))
+            {
+                fail("invalid unicode escape");
+            }
+            result = result * 16
+                     + static_cast<unsigned long>(
+                         std::isdigit(static_cast<unsigned char>(c))
+                             ? c - '0'
+                             : std::tolower(static_cast<unsigned char>(c))
+                                   - 'a' + 10);
+        }
+        return result;
+    };
+    auto read_string = [&json, &pos, &expect, &fail, &read_hex4] {
+        expect('"');
+        std::string result;
+        while (true)
+        {
+            if (pos >= json.size())
+            {
+                fail("unterminated string");
+            }
+            char c = json[pos++];
+            if (c == '"')
+            {
+                break;
+            }
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                fail("control character in string");
+            }
+            if (c != '\\')
+            {
+                result += c;
+                continue;
+            }
+            c = pos < json.size() ? json[pos++] : '\0';
+            switch (c)
+            {
+                case '"':
+                case '\\':
+                case '/':
+                    result += c;
+                    break;
+                case 'b':
+                    result += '\b';
+                    break;
+                case 'f':
+                    result += '\f';
+                    break;
+                case 'n':
+                    result += '\n';
+                    break;
+                case 'r':
+                    result += '\r';
+                    break;
+                case 't':
+                    result += '\t';
+                    break;
+                case 'u': {
+                    unsigned long cp = read_hex4();
+                    if (cp >= 0xd800 && cp < 0xdc00)
+                    {
+                        // Combine a surrogate pair
+                        if (json.substr(pos, 2) != "\\u")
+                        {
+                            fail("unpaired surrogate");
+                        }
+                        pos += 2;
+                        unsigned long low = read_hex4();
+                        if (low < 0xdc00 || low >= 0xe000)
+                        {
+                            fail("unpaired surrogate");
+                        }
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    else if (cp >= 0xdc00 && cp < 0xe000)
+                    {
+                        fail("unpaired surrogate");
+                    }
+                    append_utf8(cp, result);
+                    break;
+                }
+                default:
+                    fail("invalid escape sequence");
+            }
+        }
+        return result;
+    };
+    auto read_number = [&json, &pos, &is_digit, &fail] {
+        auto const start = pos;
+        if (json[pos] == '-')
+        {
+            ++pos;
+        }
+        if (!is_digit())
+        {
+            fail("invalid number");
+        }
+        if (json[pos++] != '0')
+        {
+            while (is_digit())
+            {
+                ++pos;
+            }
+        }
+        if (pos < json.size() && json[pos] == '.')
+        {
+            ++pos;
+            if (!is_digit())
+            {
+                fail("invalid number");
+            }
+            while (is_digit())
+            {
+                ++pos;
+            }
+        }
+        if (pos < json.size() && (json[pos] == 'e' || json[pos] == 'E'))
+        {
+            ++pos;
+            if (pos < json.size() && (json[pos] == '+' || json[pos] == '-'))
+            {
+                ++pos;
+            }
+            if (!is_digit())
+            {
+                fail("invalid number");
+            }
+            while (is_digit())
+            {
+                ++pos;
+            }
+        }
+        return std::string{json.substr(start, pos - start)};
+    };
+    auto read_value = [&json, &pos, &peek, &fail, &read_string, &read_number] {
+        char c = peek();
+        if (c == '"')
+        {
+            return read_string();
+        }
+        if (c == '-' || std::isdigit(static_cast<unsigned char>(c)))
+        {
+            return read_number();
+        }
+        for (std::string_view literal : {"true", "false"})
+        {
+            if (json.substr(pos, literal.size()) == literal)
+            {
+                pos += literal.size();
+                return std::string{literal};
+            }
+        }
+        if (c == '{' || c == '[' || json.substr(pos, 4) == "null")
+        {
+            fail("only string, number, and boolean values are supported");
+        }
+        fail("invalid value");
+        return std::string{};
+    };
+
+    ConfigItems result;
+    expect('{');
+    if (peek() != '}')
+    {
+        while (true)
+        {
+            std::string key = read_string();
+            expect(':');
+            result.emplace_back(std::move(key), read_value());
+            if (peek() != ',')
+            {
+                break;
+            }
+            ++pos;
+        }
+    }
+    expect('}');
+    skip_space();
+    if (pos != json.size())
+    {
+        fail("unexpected trailing characters");
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,29 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/JsonConfig.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+//! Ordered key/value option strings
+using ConfigItems = std::vector<std::pair<std::string, std::string>>;
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Parse a flat JSON object of scalar options into key/value strings
+ConfigItems parse_json_config(std::string_view json);
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
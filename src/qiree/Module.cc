@@ -8,15 +8,30 @@
 #include "Module.hh"
 
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <llvm/BinaryFormat/Magic.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MD5.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/IPO/AlwaysInliner.h>
 
 #include "Assert.hh"
 
@@ -28,33 +43,82 @@ namespace
 {
 //---------------------------------------------------------------------------//
 /*!
- * Shared, thread-local LLVM context.
- *
- * This must exceed the lifetime of any IR, modules, etc.
+ * Read the contents of a file.
+ */
+std::unique_ptr<llvm::MemoryBuffer> load_file(std::string const& filename)
+{
+    // Bitcode needs no null terminator, so LLVM can always map it into
+    // memory rather than reading it
+    llvm::file_magic magic{llvm::file_magic::unknown};
+    if (filename != "-")
+    {
+        // An unreadable file is reported below
+        static_cast<void>(llvm::identify_magic(filename, magic));
+    }
+    auto buffer = llvm::MemoryBuffer::getFileOrSTDIN(
+        filename,
+        /* IsText = */ false,
+        /* RequiresNullTerminator = */ magic != llvm::file_magic::bitcode);
+    QIREE_VALIDATE(buffer,
+                   << "failed to read QIR input at '" << filename
+                   << "': " << buffer.getError().message());
+    return std::move(*buffer);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether LLVM IR is bitcode rather than text.
  */
-llvm::LLVMContext& context()
+bool is_bitcode(llvm::StringRef contents)
 {
-    static llvm::LLVMContext ctx;
-    return ctx;
+    return llvm::identify_magic(contents) == llvm::file_magic::bitcode;
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Load an LLVM module from a file.
+ * Load an LLVM module from the contents of a file.
+ *
+ * Function bodies in bitcode are not read until the module is materialized,
+ * and the module refers to the buffer until then.
  */
-std::unique_ptr<llvm::Module> load_llvm_module(std::string const& filename)
+std::unique_ptr<llvm::Module>
+load_llvm_module(llvm::MemoryBuffer const& buffer, llvm::LLVMContext& ctx)
 {
+    if (is_bitcode(buffer.getBuffer()))
+    {
+        auto module = llvm::getLazyBitcodeModule(buffer.getMemBufferRef(), ctx);
+        QIREE_VALIDATE(module,
+                       << "failed to read QIR bitcode at '"
+                       << buffer.getBufferIdentifier().str()
+                       << "': " << llvm::toString(module.takeError()));
+        return std::move(*module);
+    }
+
     llvm::SMDiagnostic err;
-    auto module = llvm::parseIRFile(filename, err, context());
+    auto module = llvm::parseIR(buffer.getMemBufferRef(), err, ctx);
     if (!module)
     {
         err.print("qiree", llvm::errs());
         QIREE_VALIDATE(module,
-                       << "failed to read QIR input at '" << filename << "'");
+                       << "failed to read QIR input at '"
+                       << buffer.getBufferIdentifier().str() << "'");
     }
     return module;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Get the hexadecimal MD5 digest of LLVM IR text or bitcode.
+ */
+std::string hash_contents(llvm::MemoryBuffer const& buffer)
+{
+    llvm::MD5 hasher;
+    hasher.update(buffer.getBuffer());
+    llvm::MD5::MD5Result digest;
+    hasher.final(digest);
+    return digest.digest().str().str();
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Find a function tagged with the QIR `entry_point`.
@@ -96,6 +160,106 @@ void attr_get_to(llvm::Attribute const& attr, T& dest)
                    << std::string_view(attr.getKindAsString()) << "'");
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a QIS function measures one or more qubits.
+ */
+bool is_measurement(std::string_view name)
+{
+    return name == "__quantum__qis__mz__body"sv
+           || name == "__quantum__qis__m__body"sv
+           || name == "__quantum__qis__measure__body"sv
+           || name == "__quantum__qis__mresetz__body"sv;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a function converts a measured result to a classical value.
+ */
+bool is_result_read(std::string_view name)
+{
+    return name == "__quantum__qis__read_result__body"sv
+           || name == "__quantum__rt__read_result"sv
+           || name == "__quantum__rt__result_equal"sv;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a value can affect control flow or the operations performed.
+ *
+ * Uses of the value are followed through arithmetic, comparisons, and other
+ * non-call instructions. Reaching a terminator (branch, switch, or return), a
+ * function argument, or a store counts as feedback.
+ */
+bool has_feedback(llvm::Value const& value)
+{
+    std::vector<llvm::Value const*> stack{&value};
+    std::unordered_set<llvm::Value const*> visited{&value};
+    while (!stack.empty())
+    {
+        llvm::Value const* v = stack.back();
+        stack.pop_back();
+        for (llvm::User const* user : v->users())
+        {
+            auto const* inst = llvm::dyn_cast<llvm::Instruction>(user);
+            if (!inst || inst->isTerminator() || llvm::isa<llvm::CallBase>(inst)
+                || llvm::isa<llvm::StoreInst>(inst))
+            {
+                return true;
+            }
+            if (visited.insert(inst).second)
+            {
+                stack.push_back(inst);
+            }
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether the control flow graph of a function has a cycle.
+ */
+bool has_cycle(llvm::Function const& f)
+{
+    enum class Visit
+    {
+        active,
+        done
+    };
+    std::unordered_map<llvm::BasicBlock const*, Visit> visited;
+
+    // Iterative depth-first search: each frame is a block and the index of
+    // its next successor
+    std::vector<std::pair<llvm::BasicBlock const*, unsigned int>> stack;
+    stack.emplace_back(&f.getEntryBlock(), 0);
+    visited[&f.getEntryBlock()] = Visit::active;
+    while (!stack.empty())
+    {
+        auto& [bb, next] = stack.back();
+        auto const* term = bb->getTerminator();
+        if (!term || next == term->getNumSuccessors())
+        {
+            visited[bb] = Visit::done;
+            stack.pop_back();
+            continue;
+        }
+        llvm::BasicBlock const* succ = term->getSuccessor(next++);
+        auto iter = visited.find(succ);
+        if (iter == visited.end())
+        {
+            visited.emplace(succ, Visit::active);
+            stack.emplace_back(succ, 0);
+        }
+        else if (iter->second == Visit::active)
+        {
+            // Back edge
+            return true;
+        }
+    }
+    return false;
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace
 
@@ -113,6 +277,7 @@ Module::Module(UPModule&& module) : module_{std::move(module)}
                    << "no function with QIR 'entry_point' attribute "
                       "exists in '"
                    << module_->getSourceFileName() << "'");
+    this->materialize();
 }
 
 //---------------------------------------------------------------------------//
@@ -130,6 +295,7 @@ Module::Module(UPModule&& module, std::string const& entrypoint)
     entrypoint_ = module_->getFunction(entrypoint);
     QIREE_VALIDATE(entrypoint_,
                    << "no entrypoint function '" << entrypoint << "' exists");
+    this->materialize();
 }
 
 //---------------------------------------------------------------------------//
@@ -137,8 +303,12 @@ Module::Module(UPModule&& module, std::string const& entrypoint)
  * Construct with an LLVM IR file (bitcode or disassembled).
  */
 Module::Module(std::string const& filename)
-    : Module{load_llvm_module(filename)}
 {
+    auto ctx = std::make_unique<llvm::LLVMContext>();
+    auto buffer = load_file(filename);
+    *this = Module{load_llvm_module(*buffer, *ctx)};
+    context_ = std::move(ctx);
+    contents_ = std::move(buffer);
 }
 
 //---------------------------------------------------------------------------//
@@ -147,41 +317,57 @@ Module::Module(std::string const& filename)
  * Useful when there are multiple entry points.
  */
 Module::Module(std::string const& filename, std::string const& entrypoint)
-    : module_{load_llvm_module(filename)}
 {
-    QIREE_EXPECT(module_);
-
-    // Search for explicitly named entry point
-    entrypoint_ = module_->getFunction(entrypoint);
-    QIREE_VALIDATE(entrypoint_,
-                   << "no entrypoint function '" << entrypoint << "' exists");
+    auto ctx = std::make_unique<llvm::LLVMContext>();
+    auto buffer = load_file(filename);
+    *this = Module{load_llvm_module(*buffer, *ctx), entrypoint};
+    context_ = std::move(ctx);
+    contents_ = std::move(buffer);
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Read a module by parsing an in-memory LLVM IR string.
+ * Read a module by parsing in-memory LLVM IR text or bitcode.
+ *
+ * Bitcode is read in place and only needs to remain valid during this call,
+ * so it is hashed immediately. The text parser requires a null-terminated
+ * buffer, so text is copied (and hashed only when needed).
  */
-std::unique_ptr<Module> Module::from_bytes(std::string const& content)
+std::unique_ptr<Module> Module::from_bytes(std::string_view content)
 {
-    llvm::SMDiagnostic err;
-
-    // Create memory buffer from the in-memory IR content
-    std::unique_ptr<llvm::MemoryBuffer> buffer
-        = llvm::MemoryBuffer::getMemBuffer(content, "<in-memory>", false);
-
-    // Parse the IR using LLVM context
-    auto llvm_module = llvm::parseIR(buffer->getMemBufferRef(), err, context());
-
-    if (!llvm_module)
+    llvm::StringRef const contents{content.data(), content.size()};
+    auto ctx = std::make_unique<llvm::LLVMContext>();
+    std::unique_ptr<llvm::Module> llvm_module;
+    std::unique_ptr<llvm::MemoryBuffer> buffer;
+    std::string hash;
+    if (is_bitcode(contents))
     {
-        err.print("qiree", llvm::errs());
-        QIREE_VALIDATE(llvm_module,
-                       << "Failed to parse QIR from in-memory content '"
-                       << content << "'");
+        buffer = llvm::MemoryBuffer::getMemBuffer(
+            contents, "<in-memory>", /* RequiresNullTerminator = */ false);
+        llvm_module = load_llvm_module(*buffer, *ctx);
+        hash = hash_contents(*buffer);
+        buffer.reset();
+    }
+    else
+    {
+        llvm::SMDiagnostic err;
+        buffer = llvm::MemoryBuffer::getMemBufferCopy(contents, "<in-memory>");
+        llvm_module = llvm::parseIR(buffer->getMemBufferRef(), err, *ctx);
+        if (!llvm_module)
+        {
+            err.print("qiree", llvm::errs());
+            QIREE_VALIDATE(llvm_module,
+                           << "Failed to parse QIR from in-memory content '"
+                           << content << "'");
+        }
     }
 
     // Construct and return Module from parsed llvm::Module
-    return std::make_unique<Module>(std::move(llvm_module));
+    auto result = std::make_unique<Module>(std::move(llvm_module));
+    result->context_ = std::move(ctx);
+    result->contents_ = std::move(buffer);
+    result->content_hash_ = std::move(hash);
+    return result;
 }
 
 //! Construct in an empty state
@@ -190,7 +376,20 @@ Module::Module() = default;
 // Default destructor and move
 Module::~Module() = default;
 Module::Module(Module&&) = default;
-Module& Module::operator=(Module&&) = default;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Move-assign, destroying the IR before the context that owns it.
+ */
+Module& Module::operator=(Module&& other)
+{
+    module_ = std::move(other.module_);
+    context_ = std::move(other.context_);
+    entrypoint_ = std::exchange(other.entrypoint_, nullptr);
+    contents_ = std::move(other.contents_);
+    content_hash_ = std::move(other.content_hash_);
+    return *this;
+}
 
 //---------------------------------------------------------------------------//
 /*!
@@ -232,6 +431,7 @@ EntryPointAttrs Module::load_entry_point_attrs() const
             }
         }
     }
+    result.entry_point = entrypoint_->getName().str();
     return result;
 }
 
@@ -266,5 +466,368 @@ ModuleFlags Module::load_module_flags() const
     return flags;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Analyze the structure of the program called by the entry point.
+ *
+ * The entry point and any functions defined in the module that it
+ * (transitively) calls are inspected. Calls through function pointers are
+ * treated as internal calls.
+ */
+ModuleAnalysis Module::analyze() const
+{
+    QIREE_EXPECT(*this);
+
+    ModuleAnalysis result;
+    std::set<std::string> qis_functions;
+    bool applied_after_measure{false};
+
+    // Visit reachable functions defined in the module
+    std::vector<llvm::Function const*> stack{entrypoint_};
+    std::unordered_set<llvm::Function const*> visited{entrypoint_};
+    while (!stack.empty())
+    {
+        llvm::Function const& f = *stack.back();
+        stack.pop_back();
+
+        result.num_blocks += f.size();
+        result.has_loops = result.has_loops || has_cycle(f);
+
+        for (llvm::BasicBlock const& bb : f)
+        {
+            if (bb.getTerminator()
+                && bb.getTerminator()->getNumSuccessors() > 1)
+            {
+                result.has_branches = true;
+            }
+
+            for (llvm::Instruction const& inst : bb)
+            {
+                auto const* call = llvm::dyn_cast<llvm::CallBase>(&inst);
+                if (!call)
+                {
+                    continue;
+                }
+                llvm::Function const* callee = call->getCalledFunction();
+                if (!callee)
+                {
+                    // Indirect call
+                    result.has_internal_calls = true;
+                    continue;
+                }
+                if (!callee->isDeclaration())
+                {
+                    result.has_internal_calls = true;
+                    if (visited.insert(callee).second)
+                    {
+                        stack.push_back(callee);
+                    }
+                    continue;
+                }
+
+                auto name = std::string_view(callee->getName());
+                if (is_result_read(name))
+                {
+                    result.reads_results = true;
+                    if (has_feedback(*call))
+                    {
+                        result.result_feedback = true;
+                    }
+                }
+                if (name.substr(0, 16) != "__quantum__qis__"sv)
+                {
+                    continue;
+                }
+                qis_functions.emplace(name);
+                if (is_measurement(name))
+                {
+                    ++result.num_measurements;
+                }
+                else if (result.num_measurements > 0
+                         && !is_result_read(name))
+                {
+                    applied_after_measure = true;
+                }
+            }
+        }
+    }
+
+    result.straight_line = result.num_blocks == 1
+                           && !result.has_internal_calls;
+    result.terminal_measurements = result.straight_line
+                                   && !applied_after_measure;
+    result.qis_functions.assign(qis_functions.begin(), qis_functions.end());
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Hash of the IR the module was read from (empty if unknown).
+ *
+ * The input is only hashed the first time this is called, since it is needed
+ * only to cache compiled code, so an input file should not change while its
+ * module is in use.
+ */
+std::string const& Module::content_hash() const
+{
+    if (contents_)
+    {
+        content_hash_ = hash_contents(*contents_);
+        contents_.reset();
+    }
+    return content_hash_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Optimize the IR with an LLVM pass pipeline.
+ *
+ * The standard pipelines inline, unroll, propagate constants, and simplify
+ * control flow according to LLVM's usual heuristics. The \c qir pipeline
+ * first forces every function called by the entry point to be inlined, so
+ * that loops over qubits and helper functions emitted by front ends (e.g.,
+ * PyQIR and Q#) become straight-line code where possible, and skips
+ * vectorization, which does not help the thin classical layer of a QIR
+ * program.
+ *
+ * If a target machine is given, the module is first given its triple and
+ * data layout, and the passes use its cost model; otherwise the passes make
+ * generic assumptions about the target.
+ *
+ * Quantum and runtime functions implemented by QIR-EE can throw, so they are
+ * never assumed to be \c nounwind .
+ */
+void Module::optimize(OptLevel level, llvm::TargetMachine* target)
+{
+    QIREE_EXPECT(module_);
+    QIREE_EXPECT(level != OptLevel::size_);
+
+    this->export_entry_point();
+    if (target)
+    {
+        module_->setTargetTriple(target->getTargetTriple().str());
+        module_->setDataLayout(target->createDataLayout());
+    }
+    if (level == OptLevel::O0)
+    {
+        return;
+    }
+
+    llvm::PipelineTuningOptions tuning;
+    for (llvm::Function& f : *module_)
+    {
+        if (f.isDeclaration())
+        {
+            f.removeFnAttr(llvm::Attribute::NoUnwind);
+        }
+        else if (level == OptLevel::qir && &f != entrypoint_
+                 && !f.hasFnAttribute(llvm::Attribute::NoInline))
+        {
+            f.addFnAttr(llvm::Attribute::AlwaysInline);
+        }
+    }
+    if (level == OptLevel::qir)
+    {
+        tuning.LoopVectorization = false;
+        tuning.SLPVectorization = false;
+    }
+
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+    llvm::PassBuilder pb{target, tuning};
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    llvm::ModulePassManager mpm;
+    if (level == OptLevel::qir)
+    {
+        mpm.addPass(llvm::AlwaysInlinerPass{});
+    }
+    mpm.addPass(pb.buildPerModuleDefaultPipeline([level] {
+        switch (level)
+        {
+            case OptLevel::O1:
+                return llvm::OptimizationLevel::O1;
+            case OptLevel::O2:
+                return llvm::OptimizationLevel::O2;
+            default:
+                return llvm::OptimizationLevel::O3;
+        }
+    }()));
+    mpm.run(*module_, mam);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Give the entry point external linkage so it is never discarded.
+ *
+ * Some front ends emit an internal entry point, which the optimizer would
+ * delete and which the JIT would not export.
+ */
+void Module::export_entry_point()
+{
+    QIREE_EXPECT(entrypoint_);
+    entrypoint_->setLinkage(llvm::GlobalValue::ExternalLinkage);
+    entrypoint_->setVisibility(llvm::GlobalValue::DefaultVisibility);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the code reachable from the entry point of a lazily loaded module.
+ *
+ * Only the bodies of functions that can be reached from the entry point (or
+ * from global arrays such as \c llvm.used ) are parsed. Every other function
+ * and global variable is removed, or left as a declaration if something
+ * still refers to it. Afterward the module no longer refers to its bitcode.
+ *
+ * Modules that were parsed completely are unchanged.
+ */
+void Module::materialize()
+{
+    QIREE_EXPECT(module_ && entrypoint_);
+    if (!module_->getMaterializer())
+    {
+        return;
+    }
+
+    // Visit constants (including functions and global variables) used by
+    // reachable code
+    std::vector<llvm::Constant*> stack;
+    std::unordered_set<llvm::Constant*> visited;
+    auto visit = [&stack, &visited](llvm::Value* v) {
+        auto* c = llvm::dyn_cast_or_null<llvm::Constant>(v);
+        if (c && visited.insert(c).second)
+        {
+            stack.push_back(c);
+        }
+    };
+    visit(entrypoint_);
+    for (llvm::GlobalVariable& gv : module_->globals())
+    {
+        if (gv.hasAppendingLinkage())
+        {
+            visit(&gv);
+        }
+    }
+    for (llvm::GlobalAlias& ga : module_->aliases())
+    {
+        visit(&ga);
+    }
+    while (!stack.empty())
+    {
+        llvm::Constant* c = stack.back();
+        stack.pop_back();
+        if (auto* f = llvm::dyn_cast<llvm::Function>(c))
+        {
+            if (llvm::Error err = f->materialize())
+            {
+                QIREE_VALIDATE(false,
+                               << "failed to read QIR function '"
+                               << f->getName().str()
+                               << "': " << llvm::toString(std::move(err)));
+            }
+            for (llvm::Instruction& inst : llvm::instructions(*f))
+            {
+                for (llvm::Value* op : inst.operands())
+                {
+                    visit(op);
+                }
+            }
+        }
+        // Initializers, aliasees, and constant expression operands
+        for (llvm::Value* op : c->operands())
+        {
+            visit(op);
+        }
+    }
+
+    // Discard unreachable code without reading it
+    std::vector<llvm::GlobalObject*> unused;
+    for (llvm::Function& f : *module_)
+    {
+        if (!visited.count(&f))
+        {
+            f.deleteBody();
+            unused.push_back(&f);
+        }
+    }
+    for (llvm::GlobalVariable& gv : module_->globals())
+    {
+        if (!visited.count(&gv))
+        {
+            gv.setInitializer(nullptr);
+            gv.setLinkage(llvm::GlobalValue::ExternalLinkage);
+            unused.push_back(&gv);
+        }
+    }
+    for (llvm::GlobalObject* go : unused)
+    {
+        go->removeDeadConstantUsers();
+        if (go->use_empty())
+        {
+            go->eraseFromParent();
+        }
+    }
+
+    // Read any remaining module-level data and release the bitcode
+    if (llvm::Error err = module_->materializeAll())
+    {
+        QIREE_VALIDATE(false,
+                       << "failed to read QIR module: "
+                       << llvm::toString(std::move(err)));
+    }
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string corresponding to an optimization level.
+ */
+char const* to_cstring(Module::OptLevel value)
+{
+    switch (value)
+    {
+        case Module::OptLevel::O0:
+            return "O0";
+        case Module::OptLevel::O1:
+            return "O1";
+        case Module::OptLevel::O2:
+            return "O2";
+        case Module::OptLevel::O3:
+            return "O3";
+        case Module::OptLevel::qir:
+            return "qir";
+        default:
+            break;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get an optimization level from its name.
+ */
+Module::OptLevel to_opt_level(std::string_view name)
+{
+    for (auto i = 0; i < static_cast<int>(Module::OptLevel::size_); ++i)
+    {
+        auto level = static_cast<Module::OptLevel>(i);
+        if (name == to_cstring(level))
+        {
+            return level;
+        }
+    }
+    QIREE_VALIDATE(false,
+                   << "invalid optimization level '" << name
+                   << "' (expected O0, O1, O2, O3, or qir)");
+    return Module::OptLevel::size_;
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace qiree
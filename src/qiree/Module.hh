@@ -9,13 +9,17 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "Types.hh"
 
 namespace llvm
 {
+class LLVMContext;
 class Module;
 class Function;
+class MemoryBuffer;
+class TargetMachine;
 }  // namespace llvm
 
 namespace qiree
@@ -23,6 +27,14 @@ namespace qiree
 //---------------------------------------------------------------------------//
 /*!
  * Load a QIR LLVM module.
+ *
+ * A module read from a file or from bytes owns the LLVM context it was parsed
+ * into, so that independent modules can be compiled concurrently. A module
+ * constructed from an existing LLVM module uses the caller's context.
+ *
+ * Bitcode files are mapped into memory and read lazily: only the functions
+ * reachable from the entry point are parsed, and the rest of the module is
+ * discarded. Text IR is always parsed completely.
  */
 class Module
 {
@@ -32,9 +44,20 @@ class Module
     using UPModule = std::unique_ptr<llvm::Module>;
     //!@}
 
+    //! LLVM optimization pipeline run before compilation
+    enum class OptLevel
+    {
+        O0,  //!< No IR optimization
+        O1,  //!< LLVM -O1 pipeline
+        O2,  //!< LLVM -O2 pipeline
+        O3,  //!< LLVM -O3 pipeline
+        qir,  //!< Inline everything into the entry point, then -O3
+        size_
+    };
+
   public:
-    // Reading a module by parsing an in-memory LLVM IR string.
-    static std::unique_ptr<Module> from_bytes(std::string const& content);
+    // Read a module by parsing in-memory LLVM IR text or bitcode
+    static std::unique_ptr<Module> from_bytes(std::string_view content);
 
     // Construct from an externally created LLVM module
     explicit Module(UPModule&& module);
@@ -68,16 +91,47 @@ class Module
     // Translate module attributes into flags
     ModuleFlags load_module_flags() const;
 
+    // Analyze the structure of the program called by the entry point
+    ModuleAnalysis analyze() const;
+
+    // Hash of the IR the module was read from (empty if unknown)
+    std::string const& content_hash() const;
+
     //! True if the module has been constructed (and not moved)
     explicit operator bool() const { return static_cast<bool>(module_); }
 
+    //// MODIFIERS ////
+
+    // Optimize the IR with an LLVM pass pipeline, optionally for a target
+    void optimize(OptLevel level, llvm::TargetMachine* target = nullptr);
+
   private:
+    std::unique_ptr<llvm::LLVMContext> context_;
     std::unique_ptr<llvm::Module> module_;
     llvm::Function* entrypoint_{nullptr};
+    // Input kept until its hash is needed
+    mutable std::unique_ptr<llvm::MemoryBuffer> contents_;
+    mutable std::string content_hash_;
 
     // Make Executor a friend so it can take ownership of the pointer
     friend class Executor;
+
+    // Give the entry point external linkage so it is never discarded
+    void export_entry_point();
+
+    // Read the code reachable from the entry point of a lazy module
+    void materialize();
 };
 
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Get a string corresponding to an optimization level
+char const* to_cstring(Module::OptLevel);
+
+// Get an optimization level from its name
+Module::OptLevel to_opt_level(std::string_view name);
+
 //---------------------------------------------------------------------------//
 }  // namespace qiree
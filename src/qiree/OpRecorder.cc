@@ -0,0 +1,530 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/OpRecorder.cc
+//---------------------------------------------------------------------------//
+#include "OpRecorder.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Op = OpTape::Op;
+using OpCode = OpTape::OpCode;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a recorded runtime operation.
+ */
+Op make_record_op(OpCode code, size_type arg, OptionalCString tag)
+{
+    Op op;
+    op.code = code;
+    op.args[0] = arg;
+    op.label = tag;
+    return op;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with target interfaces and the tape to record onto.
+ */
+OpRecorder::OpRecorder(QuantumInterface& qi, RuntimeInterface& ri, OpTape& tape)
+    : qi_{qi}, ri_{ri}, tape_{tape}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Clear the tape and prepare the target for a new execution.
+ */
+void OpRecorder::set_up(EntryPointAttrs const& attrs)
+{
+    tape_.clear();
+    qi_.set_up(attrs);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete execution on the target.
+ */
+void OpRecorder::tear_down()
+{
+    qi_.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+// QUANTUM INTERFACE
+//---------------------------------------------------------------------------//
+Result OpRecorder::m(Qubit a1)
+{
+    auto result = qi_.m(a1);
+    tape_.mark_unsupported();
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+Result OpRecorder::measure(Array a1, Array a2)
+{
+    auto result = qi_.measure(a1, a2);
+    tape_.mark_unsupported();
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+Result OpRecorder::mresetz(Qubit a1)
+{
+    auto result = qi_.mresetz(a1);
+    tape_.mark_unsupported();
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::mz(Qubit a1, Result a2)
+{
+    qi_.mz(a1, a2);
+    Op op;
+    op.code = OpCode::mz;
+    op.args[0] = a1.value;
+    op.args[1] = a2.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+QState OpRecorder::read_result(Result a1) const
+{
+    auto result = qi_.read_result(a1);
+    Op op;
+    op.code = OpCode::read_result;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::ccx(Qubit a1, Qubit a2, Qubit a3)
+{
+    qi_.ccx(a1, a2, a3);
+    Op op;
+    op.code = OpCode::ccx;
+    op.args[0] = a1.value;
+    op.args[1] = a2.value;
+    op.args[2] = a3.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::cnot(Qubit a1, Qubit a2)
+{
+    qi_.cnot(a1, a2);
+    Op op;
+    op.code = OpCode::cnot;
+    op.args[0] = a1.value;
+    op.args[1] = a2.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::cx(Qubit a1, Qubit a2)
+{
+    qi_.cx(a1, a2);
+    Op op;
+    op.code = OpCode::cx;
+    op.args[0] = a1.value;
+    op.args[1] = a2.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::cy(Qubit a1, Qubit a2)
+{
+    qi_.cy(a1, a2);
+    Op op;
+    op.code = OpCode::cy;
+    op.args[0] = a1.value;
+    op.args[1] = a2.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::cz(Qubit a1, Qubit a2)
+{
+    qi_.cz(a1, a2);
+    Op op;
+    op.code = OpCode::cz;
+    op.args[0] = a1.value;
+    op.args[1] = a2.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::exp_adj(Array a1, double a2, Array a3)
+{
+    qi_.exp_adj(a1, a2, a3);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::exp(Array a1, double a2, Array a3)
+{
+    qi_.exp(a1, a2, a3);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::exp(Array a1, Tuple a2)
+{
+    qi_.exp(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::exp_adj(Array a1, Tuple a2)
+{
+    qi_.exp_adj(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::h(Qubit a1)
+{
+    qi_.h(a1);
+    Op op;
+    op.code = OpCode::h;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::h(Array a1, Qubit a2)
+{
+    qi_.h(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::r_adj(Pauli a1, double a2, Qubit a3)
+{
+    qi_.r_adj(a1, a2, a3);
+    Op op;
+    op.code = OpCode::r_adj;
+    op.args[0] = a3.value;
+    op.pauli = a1;
+    op.angle = a2;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::r(Pauli a1, double a2, Qubit a3)
+{
+    qi_.r(a1, a2, a3);
+    Op op;
+    op.code = OpCode::r;
+    op.args[0] = a3.value;
+    op.pauli = a1;
+    op.angle = a2;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::r(Array a1, Tuple a2)
+{
+    qi_.r(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::r_adj(Array a1, Tuple a2)
+{
+    qi_.r_adj(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::reset(Qubit a1)
+{
+    qi_.reset(a1);
+    Op op;
+    op.code = OpCode::reset;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::rx(double a1, Qubit a2)
+{
+    qi_.rx(a1, a2);
+    Op op;
+    op.code = OpCode::rx;
+    op.args[0] = a2.value;
+    op.angle = a1;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::rx(Array a1, Tuple a2)
+{
+    qi_.rx(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::rxx(double a1, Qubit a2, Qubit a3)
+{
+    qi_.rxx(a1, a2, a3);
+    Op op;
+    op.code = OpCode::rxx;
+    op.args[0] = a2.value;
+    op.args[1] = a3.value;
+    op.angle = a1;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::ry(double a1, Qubit a2)
+{
+    qi_.ry(a1, a2);
+    Op op;
+    op.code = OpCode::ry;
+    op.args[0] = a2.value;
+    op.angle = a1;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::ry(Array a1, Tuple a2)
+{
+    qi_.ry(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::ryy(double a1, Qubit a2, Qubit a3)
+{
+    qi_.ryy(a1, a2, a3);
+    Op op;
+    op.code = OpCode::ryy;
+    op.args[0] = a2.value;
+    op.args[1] = a3.value;
+    op.angle = a1;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::rz(double a1, Qubit a2)
+{
+    qi_.rz(a1, a2);
+    Op op;
+    op.code = OpCode::rz;
+    op.args[0] = a2.value;
+    op.angle = a1;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::rz(Array a1, Tuple a2)
+{
+    qi_.rz(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::rzz(double a1, Qubit a2, Qubit a3)
+{
+    qi_.rzz(a1, a2, a3);
+    Op op;
+    op.code = OpCode::rzz;
+    op.args[0] = a2.value;
+    op.args[1] = a3.value;
+    op.angle = a1;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::s_adj(Qubit a1)
+{
+    qi_.s_adj(a1);
+    Op op;
+    op.code = OpCode::s_adj;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::s(Qubit a1)
+{
+    qi_.s(a1);
+    Op op;
+    op.code = OpCode::s;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::s(Array a1, Qubit a2)
+{
+    qi_.s(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::s_adj(Array a1, Qubit a2)
+{
+    qi_.s_adj(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::swap(Qubit a1, Qubit a2)
+{
+    qi_.swap(a1, a2);
+    Op op;
+    op.code = OpCode::swap;
+    op.args[0] = a1.value;
+    op.args[1] = a2.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::t_adj(Qubit a1)
+{
+    qi_.t_adj(a1);
+    Op op;
+    op.code = OpCode::t_adj;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::t(Qubit a1)
+{
+    qi_.t(a1);
+    Op op;
+    op.code = OpCode::t;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::t(Array a1, Qubit a2)
+{
+    qi_.t(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::t_adj(Array a1, Qubit a2)
+{
+    qi_.t_adj(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::x(Qubit a1)
+{
+    qi_.x(a1);
+    Op op;
+    op.code = OpCode::x;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::x(Array a1, Qubit a2)
+{
+    qi_.x(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::y(Qubit a1)
+{
+    qi_.y(a1);
+    Op op;
+    op.code = OpCode::y;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::y(Array a1, Qubit a2)
+{
+    qi_.y(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::z(Qubit a1)
+{
+    qi_.z(a1);
+    Op op;
+    op.code = OpCode::z;
+    op.args[0] = a1.value;
+    tape_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::z(Array a1, Qubit a2)
+{
+    qi_.z(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::assertmeasurementprobability(Array a1,
+                                              Array a2,
+                                              Result a3,
+                                              double a4,
+                                              String a5,
+                                              double a6)
+{
+    qi_.assertmeasurementprobability(a1, a2, a3, a4, a5, a6);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::assertmeasurementprobability(Array a1, Tuple a2)
+{
+    qi_.assertmeasurementprobability(a1, a2);
+    tape_.mark_unsupported();
+}
+
+//---------------------------------------------------------------------------//
+// RUNTIME INTERFACE
+//---------------------------------------------------------------------------//
+void OpRecorder::initialize(OptionalCString env)
+{
+    ri_.initialize(env);
+    tape_.push_back(make_record_op(OpCode::initialize, 0, env));
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::array_record_output(size_type s, OptionalCString tag)
+{
+    ri_.array_record_output(s, tag);
+    tape_.push_back(make_record_op(OpCode::array_record_output, s, tag));
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::tuple_record_output(size_type s, OptionalCString tag)
+{
+    ri_.tuple_record_output(s, tag);
+    tape_.push_back(make_record_op(OpCode::tuple_record_output, s, tag));
+}
+
+//---------------------------------------------------------------------------//
+void OpRecorder::result_record_output(Result r, OptionalCString tag)
+{
+    ri_.result_record_output(r, tag);
+    tape_.push_back(
+        make_record_op(OpCode::result_record_output, r.value, tag));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,112 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/OpRecorder.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include "OpTape.hh"
+#include "QuantumInterface.hh"
+#include "RuntimeInterface.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Forward operations to a backend while recording them onto a tape.
+ *
+ * Every call is passed through unchanged to the target quantum and runtime
+ * interfaces, so executing a program with the recorder is identical to
+ * executing it with the targets directly. Operations that can't be replayed
+ * (measurements that allocate results, controlled gates, and assertions)
+ * mark the tape as unsupported.
+ *
+ * The tape is cleared when the quantum interface is set up. The caller is
+ * responsible for marking it as finished once execution completes
+ * successfully.
+ */
+class OpRecorder final : public QuantumInterface, public RuntimeInterface
+{
+  public:
+    // Construct with target interfaces and the tape to record onto
+    OpRecorder(QuantumInterface& qi, RuntimeInterface& ri, OpTape& tape);
+
+    //!@{
+    //! \name Quantum interface
+
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) const final;
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    void assertmeasurementprobability(Array,
+                                      Array,
+                                      Result,
+                                      double,
+                                      String,
+                                      double) final;
+    void assertmeasurementprobability(Array, Tuple) final;
+    //!@}
+
+    //!@{
+    //! \name Runtime interface
+
+    void initialize(OptionalCString env) final;
+    void array_record_output(size_type, OptionalCString tag) final;
+    void tuple_record_output(size_type, OptionalCString tag) final;
+    void result_record_output(Result result, OptionalCString tag) final;
+    //!@}
+
+  private:
+    QuantumInterface& qi_;
+    RuntimeInterface& ri_;
+    OpTape& tape_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,152 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/OpTape.cc
+//---------------------------------------------------------------------------//
+#include "OpTape.hh"
+
+#include "Assert.hh"
+#include "QuantumInterface.hh"
+#include "RuntimeInterface.hh"
+#include "detail/EndGuard.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Remove all operations.
+ */
+void OpTape::clear()
+{
+    ops_.clear();
+    unsupported_ = false;
+    complete_ = false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute the recorded operations on the given interfaces.
+ *
+ * This is equivalent to calling the executor: the quantum interface is set
+ * up, the operations are applied in order, and the interface is torn down
+ * even if an operation throws.
+ */
+void OpTape::replay(EntryPointAttrs const& attrs,
+                    QuantumInterface& qi,
+                    RuntimeInterface& ri) const
+{
+    QIREE_EXPECT(this->replayable());
+
+    qi.set_up(attrs);
+    detail::EndGuard on_end_scope_([&qi] { qi.tear_down(); });
+
+    for (Op const& op : ops_)
+    {
+        OpTape::apply(op, qi, ri);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single operation to the given interfaces.
+ */
+void OpTape::apply(Op const& op, QuantumInterface& qi, RuntimeInterface& ri)
+{
+    switch (op.code)
+    {
+        case OpCode::initialize:
+            ri.initialize(op.label);
+            break;
+        case OpCode::array_record_output:
+            ri.array_record_output(op.args[0], op.label);
+            break;
+        case OpCode::tuple_record_output:
+            ri.tuple_record_output(op.args[0], op.label);
+            break;
+        case OpCode::result_record_output:
+            ri.result_record_output(Result{op.args[0]}, op.label);
+            break;
+        case OpCode::mz:
+            qi.mz(Qubit{op.args[0]}, Result{op.args[1]});
+            break;
+        case OpCode::read_result:
+            static_cast<void>(qi.read_result(Result{op.args[0]}));
+            break;
+        case OpCode::r:
+            qi.r(op.pauli, op.angle, Qubit{op.args[0]});
+            break;
+        case OpCode::r_adj:
+            qi.r_adj(op.pauli, op.angle, Qubit{op.args[0]});
+            break;
+        case OpCode::ccx:
+            qi.ccx(Qubit{op.args[0]}, Qubit{op.args[1]}, Qubit{op.args[2]});
+            break;
+        case OpCode::cnot:
+            qi.cnot(Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        case OpCode::cx:
+            qi.cx(Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        case OpCode::cy:
+            qi.cy(Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        case OpCode::cz:
+            qi.cz(Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        case OpCode::swap:
+            qi.swap(Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        case OpCode::h:
+            qi.h(Qubit{op.args[0]});
+            break;
+        case OpCode::reset:
+            qi.reset(Qubit{op.args[0]});
+            break;
+        case OpCode::s:
+            qi.s(Qubit{op.args[0]});
+            break;
+        case OpCode::s_adj:
+            qi.s_adj(Qubit{op.args[0]});
+            break;
+        case OpCode::t:
+            qi.t(Qubit{op.args[0]});
+            break;
+        case OpCode::t_adj:
+            qi.t_adj(Qubit{op.args[0]});
+            break;
+        case OpCode::x:
+            qi.x(Qubit{op.args[0]});
+            break;
+        case OpCode::y:
+            qi.y(Qubit{op.args[0]});
+            break;
+        case OpCode::z:
+            qi.z(Qubit{op.args[0]});
+            break;
+        case OpCode::rx:
+            qi.rx(op.angle, Qubit{op.args[0]});
+            break;
+        case OpCode::ry:
+            qi.ry(op.angle, Qubit{op.args[0]});
+            break;
+        case OpCode::rz:
+            qi.rz(op.angle, Qubit{op.args[0]});
+            break;
+        case OpCode::rxx:
+            qi.rxx(op.angle, Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        case OpCode::ryy:
+            qi.ryy(op.angle, Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        case OpCode::rzz:
+            qi.rzz(op.angle, Qubit{op.args[0]}, Qubit{op.args[1]});
+            break;
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
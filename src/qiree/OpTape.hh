@@ -0,0 +1,129 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/OpTape.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+class QuantumInterface;
+class RuntimeInterface;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sequence of quantum and runtime operations captured from one execution.
+ *
+ * A tape is filled by \c OpRecorder while the program executes normally.
+ * If the program has no result feedback, every shot issues the same
+ * operations, so later shots can replay the tape directly into a backend
+ * without calling into the JIT-compiled code.
+ *
+ * Only operations on qubits and results (not arrays, tuples, or dynamically
+ * allocated results) can be captured. If any other operation is encountered
+ * while recording, the tape is marked as not replayable.
+ */
+class OpTape
+{
+  public:
+    //! Recorded operation type
+    enum class OpCode : std::uint8_t
+    {
+        // Runtime
+        initialize,
+        array_record_output,
+        tuple_record_output,
+        result_record_output,
+        // Measurements
+        mz,
+        read_result,
+        // Gates
+        ccx,
+        cnot,
+        cx,
+        cy,
+        cz,
+        h,
+        r,
+        r_adj,
+        reset,
+        rx,
+        rxx,
+        ry,
+        ryy,
+        rz,
+        rzz,
+        s,
+        s_adj,
+        swap,
+        t,
+        t_adj,
+        x,
+        y,
+        z,
+        size_
+    };
+
+    //! Operation and its arguments
+    struct Op
+    {
+        OpCode code{OpCode::size_};
+        Pauli pauli{Pauli::i};
+        size_type args[3]{};  //!< Qubit/result IDs or record size
+        double angle{};
+        OptionalCString label{nullptr};  //!< Reference to module constant
+    };
+
+  public:
+    //!@{
+    //! \name Recording
+
+    //! Add an operation
+    void push_back(Op const& op) { ops_.push_back(op); }
+
+    //! Note that an operation that cannot be replayed was executed
+    void mark_unsupported() { unsupported_ = true; }
+
+    //! Mark the tape as complete
+    void finish() { complete_ = true; }
+
+    // Remove all operations
+    void clear();
+    //!@}
+
+    //! Whether a complete execution was recorded
+    bool complete() const { return complete_; }
+
+    //! Whether a complete execution was recorded and can be replayed
+    bool replayable() const { return complete_ && !unsupported_; }
+
+    //! Number of recorded operations
+    size_type size() const { return ops_.size(); }
+
+    //! Access recorded operations
+    std::vector<Op> const& ops() const { return ops_; }
+
+    // Execute the recorded operations on the given interfaces
+    void replay(EntryPointAttrs const& attrs,
+                QuantumInterface& qi,
+                RuntimeInterface& ri) const;
+
+    // Apply a single operation to the given interfaces
+    static void apply(Op const& op, QuantumInterface& qi, RuntimeInterface& ri);
+
+  private:
+    std::vector<Op> ops_;
+    bool unsupported_{false};
+    bool complete_{false};
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
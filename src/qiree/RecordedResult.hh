@@ -7,7 +7,7 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
-#include <string>
+#include <string_view>
 #include <vector>
 
 #include "Types.hh"
@@ -21,6 +21,11 @@ namespace qiree
  * Each call to result_record_output appends a measurement bit (derived from
  * the provided Result) and its associated label. The storage is preallocated
  * via array_record_output.
+ *
+ * Labels are not copied: they reference the constant strings of the QIR
+ * program, which remain valid as long as the executor that ran it. Calling
+ * \c reset at the start of each shot reuses the existing storage, so
+ * recording results does not allocate once the capacity is reached.
  */
 //---------------------------------------------------------------------------//
 
@@ -30,7 +35,7 @@ class RecordedResult
     //!@{
     //! \name Type aliases
     using VecBits = std::vector<bool>;
-    using VecString = std::vector<std::string>;
+    using VecLabel = std::vector<std::string_view>;
     //!@}
 
   public:
@@ -49,17 +54,20 @@ class RecordedResult
     {
     }
 
+    // Clear results and relabel while keeping the allocated storage
+    inline void reset(std::size_t count, OptionalCString label);
+
     inline void push_back(QState result, OptionalCString label = nullptr);
 
     //! Accessors
-    std::string const& container_label() const { return container_label_; }
+    std::string_view container_label() const { return container_label_; }
     VecBits const& bits() const { return bits_; }
-    VecString const& entry_labels() const { return entry_labels_; }
+    VecLabel const& entry_labels() const { return entry_labels_; }
 
   private:
-    std::string container_label_;
+    std::string_view container_label_;
     VecBits bits_;
-    VecString entry_labels_;
+    VecLabel entry_labels_;
 };
 
 //---------------------------------------------------------------------------//
@@ -73,10 +81,21 @@ class RecordedResult
  */
 RecordedResult::RecordedResult(std::size_t count, OptionalCString label)
 {
-    if (label)
-    {
-        container_label_ = label;
-    }
+    this->reset(count, label);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Clear results and relabel while keeping the allocated storage.
+ *
+ * \param count  Number of measurement bits expected.
+ * \param label  Label for the container
+ */
+void RecordedResult::reset(std::size_t count, OptionalCString label)
+{
+    container_label_ = label ? std::string_view{label} : std::string_view{};
+    bits_.clear();
+    entry_labels_.clear();
     bits_.reserve(count);
     entry_labels_.reserve(count);
 }
@@ -88,7 +107,8 @@ RecordedResult::RecordedResult(std::size_t count, OptionalCString label)
 void RecordedResult::push_back(QState state, OptionalCString label)
 {
     bits_.push_back(static_cast<bool>(state));
-    entry_labels_.push_back(label ? label : std::string{});
+    entry_labels_.push_back(label ? std::string_view{label}
+                                  : std::string_view{});
 }
 
 //---------------------------------------------------------------------------//
@@ -8,6 +8,7 @@
 #include "ResultDistribution.hh"
 
 #include <algorithm>
+#include <sstream>
 
 #include "RecordedResult.hh"
 #include "qiree/Assert.hh"
@@ -18,21 +19,51 @@ namespace
 {
 //---------------------------------------------------------------------------//
 /*!
- * Convert bits to a bit string key ("0" for false, "1" for true).
+ * Number of 64-bit words needed to store a packed key.
+ *
+ * Zero-length keys (from programs that record no results) use a single word.
  */
-std::string to_key(std::vector<bool> const& bits)
+std::size_t num_words_for(std::size_t num_bits)
 {
-    std::string key;
-    key.reserve(bits.size());
-    for (bool bit : bits)
+    return std::max<std::size_t>(1, (num_bits + 63) / 64);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Pack bits into little-endian words.
+ */
+void pack_bits(std::vector<bool> const& bits,
+               std::vector<std::uint64_t>& words)
+{
+    words.assign(num_words_for(bits.size()), 0);
+    for (std::size_t i = 0; i < bits.size(); ++i)
     {
-        key.push_back(bit ? '1' : '0');
+        if (bits[i])
+        {
+            words[i / 64] |= (std::uint64_t{1} << (i % 64));
+        }
     }
-    return key;
 }
 
 }  // namespace
 
+//---------------------------------------------------------------------------//
+/*!
+ * Construct, using a dense histogram if the results fit in memory.
+ *
+ * The dense layout is chosen if a histogram of \c 2^required_num_results
+ * counters fits in \c max_dense_bytes . Programs that record fewer results
+ * than required use a correspondingly smaller histogram.
+ */
+ResultDistribution::ResultDistribution(EntryPointAttrs const& attrs,
+                                       size_type max_dense_bytes)
+    : max_dense_bits_{attrs.required_num_results}
+{
+    dense_enabled_ = max_dense_bits_ < 64
+                     && (max_dense_bytes / sizeof(size_type)
+                         >= (size_type(1) << max_dense_bits_));
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Accumulate a single shot.
@@ -41,10 +72,16 @@ void ResultDistribution::accumulate(RecordedResult const& result)
 {
     auto const& bits = result.bits();
 
-    if (QIREE_UNLIKELY(key_length_ == 0))
+    if (QIREE_UNLIKELY(key_length_ == 0 && this->size() == 0))
     {
         // This is the first result: store the key length
         key_length_ = bits.size();
+        counts_ = detail::PackedCountMap{num_words_for(key_length_)};
+        dense_ = dense_enabled_ && key_length_ <= max_dense_bits_;
+        if (dense_)
+        {
+            histogram_.assign(size_type(1) << key_length_, 0);
+        }
     }
     else
     {
@@ -54,7 +91,54 @@ void ResultDistribution::accumulate(RecordedResult const& result)
                        << key_length_);
     }
 
-    ++distribution_[to_key(bits)];
+    pack_bits(bits, packed_);
+    this->add_packed(packed_.data(), 1);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add the counts from another distribution.
+ *
+ * This is used to combine the distributions accumulated independently by
+ * separate threads. An empty distribution can be merged into any other.
+ */
+void ResultDistribution::merge(ResultDistribution const& other)
+{
+    if (other.size() == 0)
+    {
+        // Nothing has been accumulated in the other distribution
+        return;
+    }
+    if (this->size() == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    QIREE_VALIDATE(other.key_length_ == key_length_,
+                   << "cannot merge distribution with key length "
+                   << other.key_length_
+                   << " into distribution with key length " << key_length_);
+
+    if (dense_ && other.dense_)
+    {
+        // Sum the histograms and recount the nonzero entries
+        QIREE_ASSERT(histogram_.size() == other.histogram_.size());
+        size_type const* src = other.histogram_.data();
+        size_type* dst = histogram_.data();
+        size_type nonzero = 0;
+        for (size_type i = 0, n = histogram_.size(); i != n; ++i)
+        {
+            dst[i] += src[i];
+            nonzero += (dst[i] != 0);
+        }
+        dense_size_ = nonzero;
+        return;
+    }
+
+    other.for_each_packed([this](Word const* key, size_type count) {
+        this->add_packed(key, count);
+    });
 }
 
 //---------------------------------------------------------------------------//
@@ -71,8 +155,19 @@ std::size_t ResultDistribution::count(std::string const& key) const
                                [](char c) { return c == '0' || c == '1'; }),
                    << "invalid key: expected only '0' or '1'");
 
-    auto it = distribution_.find(key);
-    return (it != distribution_.end()) ? it->second : 0;
+    std::vector<Word> packed(num_words_for(key.size()), 0);
+    for (std::size_t i = 0; i < key.size(); ++i)
+    {
+        if (key[i] == '1')
+        {
+            packed[i / 64] |= (Word{1} << (i % 64));
+        }
+    }
+    if (dense_)
+    {
+        return histogram_[packed.front()];
+    }
+    return counts_.find(packed.data());
 }
 
 //---------------------------------------------------------------------------//
@@ -84,17 +179,84 @@ std::string ResultDistribution::to_json() const
     std::ostringstream oss;
     oss << "{";
     bool first = true;
-    for (auto const& kv : distribution_)
-    {
+    this->for_each_packed([&](Word const* key, size_type count) {
         if (!first)
             oss << ",";
         first = false;
-        oss << "\"" << kv.first << "\":" << kv.second;
-    }
+        oss << "\"" << this->to_string(key) << "\":" << count;
+    });
     oss << "}";
     return oss.str();
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Convert a packed key to a bit string ("0" for false, "1" for true).
+ */
+std::string ResultDistribution::to_string(Word const* key) const
+{
+    std::string result(key_length_, '0');
+    for (std::size_t i = 0; i < key_length_; ++i)
+    {
+        if ((key[i / 64] >> (i % 64)) & 1)
+        {
+            result[i] = '1';
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add to the count of a packed key.
+ */
+void ResultDistribution::add_packed(Word const* key, size_type count)
+{
+    if (dense_)
+    {
+        QIREE_ASSERT(key[0] < histogram_.size());
+        auto& c = histogram_[key[0]];
+        dense_size_ += (c == 0);
+        c += count;
+    }
+    else
+    {
+        counts_.add(key, count);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of storage slots (some may be empty) for iteration.
+ */
+auto ResultDistribution::num_slots() const -> size_type
+{
+    return dense_ ? histogram_.size() : counts_.capacity();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Count at a storage slot.
+ */
+auto ResultDistribution::count_at(size_type slot) const -> size_type
+{
+    return dense_ ? histogram_[slot] : counts_.count_at(slot);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * String key at a nonempty storage slot.
+ */
+std::string ResultDistribution::key_at(size_type slot) const
+{
+    if (dense_)
+    {
+        Word const key = slot;
+        return this->to_string(&key);
+    }
+    return this->to_string(counts_.key_at(slot));
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Encode a bitstring as "little endian" with shifting:
@@ -7,8 +7,14 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <cstdint>
+#include <iterator>
 #include <string>
-#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Types.hh"
+#include "detail/PackedCountMap.hh"
 
 namespace qiree
 {
@@ -27,15 +33,51 @@ class RecordedResult;
  * representation (i.e., a base-2 encoding of the qubits). It is serializable
  * to JSON, creating an object that has bit strings as keys and counts as
  * values.
+ *
+ * Internally, each bit string is packed into one or more 64-bit words (bit \c
+ * i is stored as <code>(word[i / 64] >> (i % 64)) & 1</code>) in an
+ * open-addressing hash table, so accumulating a shot does not allocate. String
+ * keys are only constructed on demand when iterating or serializing; use
+ * \c for_each_packed to access the packed keys directly.
+ *
+ * When constructed from the entry point attributes of a program with few
+ * results, the distribution instead uses a dense histogram of \f$ 2^n \f$
+ * counters indexed by the packed key. The dense layout is used only if it
+ * fits within a memory limit (by default 8 MiB, i.e. up to 20 results), and
+ * merging two dense distributions is a single elementwise sum.
  */
 class ResultDistribution
 {
   public:
+    //!@{
+    //! \name Type aliases
+    using Word = detail::PackedCountMap::Word;
+    using size_type = std::size_t;
+    //!@}
+
+    class const_iterator;
+
+    //! Default maximum memory for a dense histogram
+    static constexpr size_type default_max_dense_bytes = size_type(8) << 20;
+
+  public:
+    // Construct an empty sparse distribution
+    ResultDistribution() = default;
+
+    // Construct, using a dense histogram if the results fit in memory
+    explicit ResultDistribution(
+        EntryPointAttrs const& attrs,
+        size_type max_dense_bytes = default_max_dense_bytes);
+
     // Accumulate the results from a RecordedResult instance.
     // Throws if the bit-length of the new result
     // differs from previously accumulated ones.
     void accumulate(RecordedResult const& result);
 
+    // Add the counts from another distribution (e.g., from another thread).
+    // Throws if the bit-lengths of the two distributions differ.
+    void merge(ResultDistribution const& other);
+
     // Access the count for a given bit string key (e.g. "01001").
     // Returns 0 if the key is not present.
     std::size_t count(std::string const& key) const;
@@ -44,27 +86,171 @@ class ResultDistribution
     // The JSON object has bit string keys and count values.
     std::string to_json() const;
 
+    // Convert a packed key to a bit string
+    std::string to_string(Word const* key) const;
+
+    // Call visit(Word const* key, size_type count) for each nonzero entry
+    template<class F>
+    inline void for_each_packed(F&& visit) const;
+
     //!@{
-    //! Iterate over the nonzero keys
-    auto begin() const { return distribution_.begin(); }
-    auto end() const { return distribution_.end(); }
+    //! Iterate over the nonzero {bit string, count} pairs
+    inline const_iterator begin() const;
+    inline const_iterator end() const;
     //!@}
 
     //! Get the number of nonzero entries
-    auto size() const throw() { return distribution_.size(); }
+    size_type size() const { return dense_ ? dense_size_ : counts_.size(); }
+
+    //! Number of bits in each key
+    size_type num_bits() const { return key_length_; }
+
+    //! Number of 64-bit words in each packed key
+    size_type num_words() const { return counts_.num_words(); }
+
+    //! Whether counts are stored in a dense histogram
+    bool dense() const { return dense_; }
 
   private:
-    // Sparse map of {bit string -> count}
-    std::unordered_map<std::string, std::size_t> distribution_;
+    // Sparse map of {packed bits -> count}
+    detail::PackedCountMap counts_;
+
+    // Dense histogram indexed by packed bits, if enabled
+    std::vector<size_type> histogram_;
+    size_type dense_size_{0};
+    size_type max_dense_bits_{0};
+    bool dense_enabled_{false};
+    bool dense_{false};
 
     // key_length_ is 0 until the first RecordedResult is accumulated.
     // All subsequent RecordedResult instances must have the same bit length.
     std::size_t key_length_ = 0;
+
+    // Reusable buffer for packing a key
+    std::vector<Word> packed_;
+
+    //// HELPER FUNCTIONS ////
+
+    void add_packed(Word const* key, size_type count);
+    size_type num_slots() const;
+    size_type count_at(size_type slot) const;
+    std::string key_at(size_type slot) const;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Iterate over the {bit string, count} pairs of a distribution.
+ *
+ * The string key is constructed when the iterator is dereferenced.
+ */
+class ResultDistribution::const_iterator
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<std::string, std::size_t>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+    //!@}
+
+  public:
+    //! Construct at a given slot of the distribution
+    const_iterator(ResultDistribution const& dist, size_type slot)
+        : dist_{&dist}, slot_{slot}
+    {
+        this->skip_empty();
+    }
+
+    //! Construct the key and return the {key, count} pair
+    value_type operator*() const
+    {
+        return {dist_->key_at(slot_), dist_->count_at(slot_)};
+    }
+
+    //! Advance to the next nonzero entry
+    const_iterator& operator++()
+    {
+        ++slot_;
+        this->skip_empty();
+        return *this;
+    }
+
+    //!@{
+    //! Compare
+    bool operator==(const_iterator const& other) const
+    {
+        return slot_ == other.slot_;
+    }
+    bool operator!=(const_iterator const& other) const
+    {
+        return !(*this == other);
+    }
+    //!@}
+
+  private:
+    ResultDistribution const* dist_;
+    size_type slot_;
+
+    void skip_empty()
+    {
+        auto const num_slots = dist_->num_slots();
+        while (slot_ != num_slots && dist_->count_at(slot_) == 0)
+        {
+            ++slot_;
+        }
+    }
 };
 
 // Encode a bitstring as "little endian" with shifting:
 // register N is  `(value >> N) & 1` for N in [0, 64)
 void encode_bit_string(std::string const& key, std::uint64_t& result);
 
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Call a function for each nonzero entry.
+ *
+ * The function is called as \c visit(Word const* key, size_type count) , where
+ * \c key points to \c num_words() packed words.
+ */
+template<class F>
+void ResultDistribution::for_each_packed(F&& visit) const
+{
+    if (!dense_)
+    {
+        counts_.for_each(std::forward<F>(visit));
+        return;
+    }
+    for (size_type i = 0; i != histogram_.size(); ++i)
+    {
+        if (histogram_[i] != 0)
+        {
+            Word const key = i;
+            visit(&key, histogram_[i]);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Iterator to the first nonzero entry.
+ */
+auto ResultDistribution::begin() const -> const_iterator
+{
+    return {*this, 0};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Iterator past the last entry.
+ */
+auto ResultDistribution::end() const -> const_iterator
+{
+    return {*this, this->num_slots()};
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace qiree
@@ -0,0 +1,309 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultSink.cc
+//---------------------------------------------------------------------------//
+#include "ResultSink.hh"
+
+#include <cstdint>
+
+#include "Assert.hh"
+#include "ExternalDistribution.hh"
+#include "ResultDistribution.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Write one JSON object per record.
+ */
+class NdjsonResultSink final : public ResultSink
+{
+  public:
+    explicit NdjsonResultSink(std::ostream& os) : ResultSink{os} {}
+
+    void write(std::string_view label,
+               std::string_view bits,
+               size_type count) final
+    {
+        auto& buf = this->buffer();
+        buf += "{\"label\":\"";
+        append_escaped(label, buf);
+        buf += "\",\"bits\":\"";
+        buf += bits;
+        buf += "\",\"count\":";
+        buf += std::to_string(count);
+        buf += "}\n";
+        this->commit();
+    }
+
+    using ResultSink::write;
+
+  private:
+    static void append_escaped(std::string_view s, std::string& buf)
+    {
+        static char const hex[] = "0123456789abcdef";
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                buf += '\\';
+                buf += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                buf += "\\u00";
+                buf += hex[(c >> 4) & 0xf];
+                buf += hex[c & 0xf];
+            }
+            else
+            {
+                buf += c;
+            }
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write comma-separated values with a header line.
+ */
+class CsvResultSink final : public ResultSink
+{
+  public:
+    explicit CsvResultSink(std::ostream& os) : ResultSink{os}
+    {
+        this->buffer() += "label,bits,count\n";
+    }
+
+    void write(std::string_view label,
+               std::string_view bits,
+               size_type count) final
+    {
+        auto& buf = this->buffer();
+        if (label.find_first_of(",\"\r\n") == std::string_view::npos)
+        {
+            buf += label;
+        }
+        else
+        {
+            // Quote the field and double any quotes in it
+            buf += '"';
+            for (char c : label)
+            {
+                if (c == '"')
+                {
+                    buf += '"';
+                }
+                buf += c;
+            }
+            buf += '"';
+        }
+        buf += ',';
+        buf += bits;
+        buf += ',';
+        buf += std::to_string(count);
+        buf += '\n';
+        this->commit();
+    }
+
+    using ResultSink::write;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write packed little-endian records.
+ */
+class BinaryResultSink final : public ResultSink
+{
+  public:
+    //! Version of the record layout
+    static constexpr std::uint32_t version = 1;
+
+    explicit BinaryResultSink(std::ostream& os) : ResultSink{os}
+    {
+        this->buffer() += "QIRR";
+        this->append_int(version);
+    }
+
+    void write(std::string_view label,
+               std::string_view bits,
+               size_type count) final
+    {
+        auto& buf = this->buffer();
+        this->append_int(static_cast<std::uint32_t>(label.size()));
+        buf += label;
+
+        this->append_int(static_cast<std::uint32_t>(bits.size()));
+        auto const start = buf.size();
+        buf.append((bits.size() + 7) / 8, '\0');
+        for (size_type i = 0; i < bits.size(); ++i)
+        {
+            QIREE_EXPECT(bits[i] == '0' || bits[i] == '1');
+            if (bits[i] == '1')
+            {
+                buf[start + i / 8] |= static_cast<char>(1 << (i % 8));
+            }
+        }
+
+        this->append_int(static_cast<std::uint64_t>(count));
+        this->commit();
+    }
+
+    using ResultSink::write;
+
+  private:
+    template<class T>
+    void append_int(T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            this->buffer() += static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the output stream.
+ */
+ResultSink::ResultSink(std::ostream& os) : os_{os}
+{
+    buffer_.reserve(buffer_size);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write any buffered records.
+ */
+ResultSink::~ResultSink()
+{
+    this->flush();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write every entry of a distribution.
+ */
+void ResultSink::write(std::string_view label, ResultDistribution const& dist)
+{
+    for (auto const& [bits, count] : dist)
+    {
+        this->write(label, bits, count);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write every entry of a distribution spilled to disk.
+ *
+ * Entries are written in order of their packed keys as the runs are merged,
+ * so the distribution is never fully loaded into memory.
+ */
+void ResultSink::write(std::string_view label, ExternalDistribution const& dist)
+{
+    dist.for_each_packed([&](ExternalDistribution::Word const* key,
+                             size_type count) {
+        this->write(label, dist.to_string(key), count);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write buffered records to the stream.
+ */
+void ResultSink::flush()
+{
+    if (!buffer_.empty())
+    {
+        os_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+    os_.flush();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Flush the buffer if it is full.
+ */
+void ResultSink::commit()
+{
+    if (buffer_.size() >= buffer_size)
+    {
+        os_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the name of a result format.
+ */
+char const* to_cstring(ResultFormat value)
+{
+    switch (value)
+    {
+        case ResultFormat::ndjson:
+            return "ndjson";
+        case ResultFormat::csv:
+            return "csv";
+        case ResultFormat::binary:
+            return "binary";
+        default:
+            break;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a result format from its name.
+ */
+ResultFormat to_result_format(std::string_view name)
+{
+    for (auto i = 0; i < static_cast<int>(ResultFormat::size_); ++i)
+    {
+        auto format = static_cast<ResultFormat>(i);
+        if (name == to_cstring(format))
+        {
+            return format;
+        }
+    }
+    QIREE_VALIDATE(false,
+                   << "invalid result format '" << name
+                   << "' (expected ndjson, csv, or binary)");
+    return ResultFormat::size_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a result sink that writes to a stream.
+ */
+std::unique_ptr<ResultSink>
+make_result_sink(ResultFormat format, std::ostream& os)
+{
+    switch (format)
+    {
+        case ResultFormat::ndjson:
+            return std::make_unique<NdjsonResultSink>(os);
+        case ResultFormat::csv:
+            return std::make_unique<CsvResultSink>(os);
+        case ResultFormat::binary:
+            return std::make_unique<BinaryResultSink>(os);
+        default:
+            break;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,114 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultSink.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "Macros.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+class ExternalDistribution;
+class ResultDistribution;
+
+//---------------------------------------------------------------------------//
+//! Machine-readable format of written results
+enum class ResultFormat
+{
+    ndjson,  //!< One JSON object per line
+    csv,  //!< Comma-separated values with a header line
+    binary,  //!< Packed little-endian records
+    size_
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write measurement counts to a stream in a machine-readable format.
+ *
+ * Each record is a labeled bit string and the number of times it was
+ * measured. The label identifies the group of results (e.g. the tuple or
+ * array tag); the bit string is little-endian, i.e. its first character is
+ * the first result of the group.
+ *
+ * Records are accumulated in a buffer that is written to the stream only
+ * when it fills, when \c flush is called, and when the sink is destroyed, so
+ * large result sets can be streamed without flushing on every line.
+ *
+ * The formats are:
+ * - \c ndjson : <code>{"label":"ret","bits":"01","count":512}</code> per
+ *   line;
+ * - \c csv : a <code>label,bits,count</code> header followed by one line per
+ *   record, with labels quoted if needed; and
+ * - \c binary : the four bytes \c QIRR and a 32-bit version, followed by
+ *   records of a 32-bit label length, the label, a 32-bit number of bits,
+ *   the bits packed eight to a byte (bit \em i is bit <code>i % 8</code> of
+ *   byte <code>i / 8</code>), and a 64-bit count. All integers are
+ *   little-endian.
+ */
+class ResultSink
+{
+  public:
+    //! Buffer size above which records are written to the stream
+    static constexpr size_type buffer_size = size_type(1) << 16;
+
+  public:
+    // Write any buffered records
+    virtual ~ResultSink();
+
+    //! Prevent copying
+    QIREE_DELETE_COPY_MOVE(ResultSink);
+
+    // Write the count of a bit string
+    virtual void
+    write(std::string_view label, std::string_view bits, size_type count)
+        = 0;
+
+    // Write every entry of a distribution
+    void write(std::string_view label, ResultDistribution const& dist);
+
+    // Write every entry of a distribution spilled to disk
+    void write(std::string_view label, ExternalDistribution const& dist);
+
+    // Write buffered records to the stream
+    void flush();
+
+  protected:
+    // Construct with the output stream
+    explicit ResultSink(std::ostream& os);
+
+    //! Buffer for formatted records
+    std::string& buffer() { return buffer_; }
+
+    // Flush the buffer if it is full
+    void commit();
+
+  private:
+    std::ostream& os_;
+    std::string buffer_;
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Get the name of a result format
+char const* to_cstring(ResultFormat value);
+
+// Get a result format from its name
+ResultFormat to_result_format(std::string_view name);
+
+// Create a result sink that writes to a stream
+std::unique_ptr<ResultSink>
+make_result_sink(ResultFormat format, std::ostream& os);
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
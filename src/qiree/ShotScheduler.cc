@@ -0,0 +1,229 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ShotScheduler.cc
+//---------------------------------------------------------------------------//
+#include "ShotScheduler.hh"
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Assert.hh"
+#include "Executor.hh"
+#include "ExternalDistribution.hh"
+#include "OpRecorder.hh"
+#include "QuantumInterface.hh"
+#include "ShotWriter.hh"
+#include "SingleResultRuntime.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with an executor, a backend factory, and options.
+ *
+ * The executor must outlive this instance. One backend is created per worker.
+ */
+ShotScheduler::ShotScheduler(Executor const& execute,
+                             BackendFactory make_backend,
+                             Options const& opts)
+    : execute_{execute}
+    , num_threads_{opts.num_threads}
+    , seed_{opts.seed}
+    , replay_{opts.replay && !execute.analysis().result_feedback}
+    , batch_size_{opts.batch_size}
+{
+    QIREE_EXPECT(make_backend);
+    QIREE_EXPECT(batch_size_ > 0);
+    if (num_threads_ == 0)
+    {
+        num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    backends_.reserve(num_threads_);
+    for (unsigned int worker = 0; worker < num_threads_; ++worker)
+    {
+        backends_.push_back(make_backend(this->worker_seed(worker)));
+        auto const& b = backends_.back();
+        QIREE_VALIDATE(b.quantum && b.runtime,
+                       << "backend factory did not create a quantum and "
+                          "runtime interface");
+    }
+    tapes_.resize(num_threads_);
+    worker_shots_run_.resize(num_threads_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run the given number of shots and return the combined distribution.
+ *
+ * If any worker throws, the remaining workers are allowed to complete and the
+ * first exception (by worker index) is rethrown.
+ *
+ * Even a single worker runs on its own thread, so that per-thread state set
+ * by a backend (such as CPU affinity) never leaks into the caller.
+ *
+ * The optional \c shots writer receives the results of every shot.
+ */
+ResultDistribution
+ShotScheduler::operator()(size_type num_shots, ShotWriter* shots)
+{
+    // Use a dense histogram if the program has few enough results
+    std::vector<ResultDistribution> results(
+        num_threads_, ResultDistribution{execute_.entry_point_attrs()});
+
+    std::vector<std::exception_ptr> errors(num_threads_);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads_);
+    for (unsigned int worker = 0; worker < num_threads_; ++worker)
+    {
+        if (this->worker_shots(num_shots, worker) == 0)
+        {
+            continue;
+        }
+        threads.emplace_back(
+            [this, worker, num_shots, shots, &results, &errors] {
+                auto save_error
+                    = [&error = errors[worker]](std::exception_ptr e) {
+                          error = std::move(e);
+                      };
+                QIREE_TRY_HANDLE(this->run_worker(
+                                     worker, num_shots, results[worker], shots),
+                                 save_error);
+            });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    num_shots_run_ += num_shots;
+    for (auto& e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+
+    // Combine results
+    ResultDistribution result = std::move(results.front());
+    for (auto iter = results.begin() + 1; iter != results.end(); ++iter)
+    {
+        result.merge(*iter);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run shots in batches, merging each into a distribution on disk.
+ *
+ * Only one batch of results is counted in memory at a time. Shots are
+ * numbered and seeded as if run by consecutive calls of \c batch_size shots.
+ */
+void ShotScheduler::operator()(size_type num_shots,
+                               ExternalDistribution& result,
+                               ShotWriter* shots)
+{
+    while (num_shots > 0)
+    {
+        size_type const n = std::min(num_shots, batch_size_);
+        result.merge((*this)(n, shots));
+        num_shots -= n;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Seed used by a particular worker.
+ *
+ * Backends such as qsim increment their seed for every sample, so adjacent
+ * workers are separated by a large odd stride rather than by one.
+ */
+unsigned long int ShotScheduler::worker_seed(unsigned int worker) const
+{
+    QIREE_EXPECT(worker < num_threads_);
+    constexpr unsigned long int stride = 0x9e3779b97f4a7c15ull;
+    return seed_ + worker * stride;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of shots executed by a particular worker.
+ */
+size_type
+ShotScheduler::worker_shots(size_type num_shots, unsigned int worker) const
+{
+    QIREE_EXPECT(worker < num_threads_);
+    return num_shots / num_threads_ + (worker < num_shots % num_threads_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run shots on a single thread.
+ *
+ * If replay is enabled, the first shot executed by this worker is recorded.
+ * Later shots (including those in subsequent calls) replay the recording if
+ * it captured every operation, or fall back to the executor otherwise.
+ */
+void ShotScheduler::run_worker(unsigned int worker,
+                               size_type num_shots,
+                               ResultDistribution& result,
+                               ShotWriter* shots)
+{
+    Backend& backend = backends_[worker];
+    OpTape& tape = tapes_[worker];
+
+    // Workers run consecutive ranges of shots
+    std::optional<ShotWriter::Buffer> shot_buffer;
+    if (shots)
+    {
+        size_type first_shot = num_shots_run_;
+        for (unsigned int w = 0; w < worker; ++w)
+        {
+            first_shot += this->worker_shots(num_shots, w);
+        }
+        shot_buffer.emplace(*shots, first_shot);
+    }
+    auto const seed = this->worker_seed(worker);
+    size_type& position = worker_shots_run_[worker];
+
+    for (auto n = this->worker_shots(num_shots, worker); n > 0; --n)
+    {
+        if (tape.replayable())
+        {
+            tape.replay(execute_.entry_point_attrs(),
+                        *backend.quantum,
+                        *backend.runtime);
+        }
+        else if (replay_ && !tape.complete())
+        {
+            OpRecorder record{*backend.quantum, *backend.runtime, tape};
+            execute_(record, record);
+            tape.finish();
+        }
+        else
+        {
+            execute_(*backend.quantum, *backend.runtime);
+        }
+        result.accumulate(backend.runtime->result());
+        if (shot_buffer)
+        {
+            shot_buffer->append(seed, position, backend.runtime->result());
+        }
+        ++position;
+    }
+    if (shot_buffer)
+    {
+        shot_buffer->flush();
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,141 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ShotScheduler.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "OpTape.hh"
+#include "ResultDistribution.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+class Executor;
+class ExternalDistribution;
+class QuantumInterface;
+class ShotWriter;
+class SingleResultRuntime;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run many shots of a compiled program, optionally on multiple threads.
+ *
+ * A quantum/runtime backend pair is created for each worker thread at
+ * construction using the user-provided factory function. Each worker executes
+ * its share of the shots on its own backend and accumulates results into a
+ * thread-local distribution, and the per-thread distributions are merged at
+ * the end. Backends persist between calls, so repeated runs continue each
+ * worker's random number sequence.
+ *
+ * The shots are split as evenly as possible across workers, and each worker
+ * receives a seed derived deterministically from the base seed and its worker
+ * index. The result is therefore reproducible for a fixed number of threads.
+ * Worker zero uses the base seed unmodified, so a single-threaded run is
+ * identical to executing the shots serially with a single backend.
+ *
+ * If static analysis shows that the program never branches on a measurement
+ * result, every shot issues the same sequence of operations. In that case
+ * each worker records its first shot with an \c OpRecorder and replays the
+ * resulting \c OpTape for subsequent shots, bypassing the JIT-compiled code.
+ * Since the backend sees an identical sequence of calls, the results are the
+ * same as with replay disabled.
+ *
+ * Each worker runs a contiguous range of shots, numbered consecutively across
+ * calls. Programs whose results are too varied to count in memory can instead
+ * accumulate into an \c ExternalDistribution , to which shots are merged in
+ * batches. If a \c ShotWriter is given, every shot's results are also written
+ * to it with the shot's number, the seed of the worker that ran it, and the
+ * shot's position in that worker's sequence. Since a backend is seeded once,
+ * a shot is reproduced by running a new backend with the worker seed for
+ * that many shots and then one more.
+ *
+ * \code
+   ShotScheduler run_shots{execute, [](unsigned long seed) {
+       auto sim = std::make_shared<QsimQuantum>(std::cout, seed);
+       auto rt = std::make_shared<QsimRuntime>(std::cout, *sim);
+       return ShotScheduler::Backend{std::move(sim), std::move(rt)};
+   }, {num_threads, seed}};
+   ResultDistribution distribution = run_shots(num_shots);
+ * \endcode
+ */
+class ShotScheduler
+{
+  public:
+    //! Quantum and runtime interfaces used by a single worker
+    struct Backend
+    {
+        std::shared_ptr<QuantumInterface> quantum;
+        std::shared_ptr<SingleResultRuntime> runtime;
+    };
+
+    //! Create a backend given a seed
+    using BackendFactory = std::function<Backend(unsigned long int)>;
+
+    //! Scheduling options
+    struct Options
+    {
+        //! Number of worker threads (zero for hardware concurrency)
+        unsigned int num_threads{1};
+        //! Base random number seed
+        unsigned long int seed{0};
+        //! Replay the first shot if the program has no result feedback
+        bool replay{true};
+        //! Shots per batch when accumulating into an external distribution
+        size_type batch_size{size_type(1) << 16};
+    };
+
+  public:
+    // Construct with an executor, a backend factory, and options
+    ShotScheduler(Executor const& execute,
+                  BackendFactory make_backend,
+                  Options const& opts);
+
+    // Run the given number of shots and return the combined distribution
+    ResultDistribution
+    operator()(size_type num_shots, ShotWriter* shots = nullptr);
+
+    // Run shots in batches, merging each into a distribution on disk
+    void operator()(size_type num_shots,
+                    ExternalDistribution& result,
+                    ShotWriter* shots = nullptr);
+
+    //! Number of worker threads
+    unsigned int num_threads() const { return num_threads_; }
+
+    // Seed used by a particular worker
+    unsigned long int worker_seed(unsigned int worker) const;
+
+    // Number of shots executed by a particular worker
+    size_type worker_shots(size_type num_shots, unsigned int worker) const;
+
+    //! Total number of shots run by all calls
+    size_type num_shots_run() const { return num_shots_run_; }
+
+  private:
+    Executor const& execute_;
+    unsigned int num_threads_;
+    unsigned long int seed_;
+    bool replay_;
+    size_type batch_size_;
+    std::vector<Backend> backends_;
+    std::vector<OpTape> tapes_;
+    std::vector<size_type> worker_shots_run_;
+    size_type num_shots_run_{0};
+
+    // Run shots on a single thread
+    void run_worker(unsigned int worker,
+                    size_type num_shots,
+                    ResultDistribution& result,
+                    ShotWriter* shots);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,169 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ShotWriter.cc
+//---------------------------------------------------------------------------//
+#include "ShotWriter.hh"
+
+#include "Assert.hh"
+#include "RecordedResult.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Append a little-endian integer.
+ */
+template<class T>
+void append_int(T value, std::string& buf)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        buf += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Size of a record with the given number of bits.
+ */
+size_type record_size(size_type num_bits)
+{
+    return 3 * sizeof(std::uint64_t) + (num_bits + 7) / 8;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Open a file for writing.
+ */
+ShotWriter::ShotWriter(std::string const& filename)
+    : filename_{filename}
+    , out_{filename, std::ios::out | std::ios::binary | std::ios::trunc}
+{
+    QIREE_VALIDATE(out_,
+                   << "failed to open shot output file '" << filename_
+                   << "'");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Flush written chunks to disk.
+ */
+void ShotWriter::flush()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    out_.flush();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write consecutive records starting at a shot.
+ *
+ * The first chunk determines the number of bits per shot and writes the
+ * header; every later chunk must have the same number of bits.
+ */
+void ShotWriter::write_chunk(size_type first_shot,
+                             size_type num_bits,
+                             std::string const& data)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!started_)
+    {
+        std::string header{"QIRS"};
+        append_int(version, header);
+        append_int(static_cast<std::uint32_t>(num_bits), header);
+        append_int(static_cast<std::uint32_t>(record_size(num_bits)), header);
+        QIREE_ASSERT(header.size() == header_size);
+        out_.seekp(0);
+        out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+        num_bits_ = num_bits;
+        started_ = true;
+    }
+    QIREE_VALIDATE(num_bits == num_bits_,
+                   << "shots recorded " << num_bits << " results but "
+                   << "earlier shots recorded " << num_bits_);
+
+    out_.seekp(static_cast<std::streamoff>(
+        header_size + first_shot * record_size(num_bits)));
+    out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    QIREE_VALIDATE(out_,
+                   << "failed to write shots to '" << filename_ << "'");
+}
+
+//---------------------------------------------------------------------------//
+// BUFFER
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the writer and the index of the next shot.
+ */
+ShotWriter::Buffer::Buffer(ShotWriter& writer, size_type first_shot)
+    : writer_{&writer}, first_shot_{first_shot}
+{
+    data_.reserve(chunk_size);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Append the next shot.
+ *
+ * The seed is that of the backend that ran the shot, and the position is the
+ * number of shots the backend ran before it.
+ */
+void ShotWriter::Buffer::append(unsigned long int seed,
+                                size_type position,
+                                RecordedResult const& result)
+{
+    auto const& bits = result.bits();
+    if (num_shots_ == 0)
+    {
+        num_bits_ = bits.size();
+    }
+    QIREE_VALIDATE(bits.size() == num_bits_,
+                   << "shot recorded " << bits.size() << " results but "
+                   << "earlier shots recorded " << num_bits_);
+
+    append_int(static_cast<std::uint64_t>(first_shot_ + num_shots_), data_);
+    append_int(static_cast<std::uint64_t>(seed), data_);
+    append_int(static_cast<std::uint64_t>(position), data_);
+    auto const start = data_.size();
+    data_.append((num_bits_ + 7) / 8, '\0');
+    for (size_type i = 0; i < num_bits_; ++i)
+    {
+        if (bits[i])
+        {
+            data_[start + i / 8] |= static_cast<char>(1 << (i % 8));
+        }
+    }
+    ++num_shots_;
+
+    if (data_.size() >= chunk_size)
+    {
+        this->flush();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write buffered shots to the file.
+ */
+void ShotWriter::Buffer::flush()
+{
+    if (num_shots_ == 0)
+    {
+        return;
+    }
+    writer_->write_chunk(first_shot_, num_bits_, data_);
+    first_shot_ += num_shots_;
+    num_shots_ = 0;
+    data_.clear();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,108 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ShotWriter.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "Macros.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+class RecordedResult;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write the result of every shot to a binary file of fixed-width records.
+ *
+ * The file starts with the four bytes \c QIRS and three 32-bit integers: the
+ * format version, the number of bits per shot, and the size of each record.
+ * Record \em i holds shot \em i : its 64-bit index, the 64-bit seed of the
+ * backend that ran it, the 64-bit number of shots that backend ran before
+ * it, and its results packed eight to a byte (result \em j is bit
+ * <code>j % 8</code> of byte <code>j / 8</code>). All integers are
+ * little-endian.
+ *
+ * Backends are seeded once rather than for every shot, so a shot is
+ * reproduced by creating a backend with the recorded seed and running one
+ * more shot than the recorded position.
+ *
+ * Because records have a fixed width, each is written at its final position
+ * in the file and the file is in shot order no matter how shots are divided
+ * among threads. Threads format records into their own \c Buffer and only
+ * take a lock to write a full chunk.
+ */
+class ShotWriter
+{
+  public:
+    class Buffer;
+
+    //! Version of the file layout
+    static constexpr std::uint32_t version = 2;
+    //! Size of the file header in bytes
+    static constexpr size_type header_size = 16;
+    //! Size of the record buffer written at once by each thread
+    static constexpr size_type chunk_size = size_type(1) << 16;
+
+  public:
+    // Open a file for writing
+    explicit ShotWriter(std::string const& filename);
+
+    //! Prevent copying
+    QIREE_DELETE_COPY_MOVE(ShotWriter);
+
+    // Flush written chunks to disk
+    void flush();
+
+  private:
+    std::string filename_;
+    std::ofstream out_;
+    std::mutex mutex_;
+    size_type num_bits_{0};
+    bool started_{false};
+
+    // Write consecutive records starting at a shot
+    void write_chunk(size_type first_shot,
+                     size_type num_bits,
+                     std::string const& data);
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Format consecutive shots for a single thread.
+ *
+ * Records are written to the file when the buffer fills and when \c flush is
+ * called, which must be done after the last shot.
+ */
+class ShotWriter::Buffer
+{
+  public:
+    // Construct with the writer and the index of the next shot
+    Buffer(ShotWriter& writer, size_type first_shot);
+
+    // Append the next shot
+    void append(unsigned long int seed,
+                size_type position,
+                RecordedResult const& result);
+
+    // Write buffered shots to the file
+    void flush();
+
+  private:
+    ShotWriter* writer_;
+    size_type first_shot_;
+    size_type num_shots_{0};
+    size_type num_bits_{0};
+    std::string data_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
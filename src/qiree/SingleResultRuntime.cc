@@ -16,14 +16,14 @@ namespace qiree
 void SingleResultRuntime::array_record_output(size_type size,
                                               OptionalCString tag)
 {
-    result_ = RecordedResult(size, tag);
+    result_.reset(size, tag);
 }
 
 //! Mark the following N results as being part of a tuple named tag
 void SingleResultRuntime::tuple_record_output(size_type size,
                                               OptionalCString tag)
 {
-    result_ = RecordedResult(size, tag);
+    result_.reset(size, tag);
 }
 
 //! Save one result
@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace qiree
 {
@@ -51,6 +52,10 @@ struct EntryPointAttrs
     size_type required_num_results{};
     std::string output_labeling_schema;
     std::string qir_profiles;
+    //! Name of the entry point function
+    std::string entry_point;
+    //! Hash of the module contents, if requested (see \c Executor::Options)
+    std::string module_hash;
 };
 
 //---------------------------------------------------------------------------//
@@ -65,6 +70,39 @@ struct ModuleFlags
     bool dynamic_result_management{};
 };
 
+//---------------------------------------------------------------------------//
+/*!
+ * Static structure of the program called by an entry point.
+ *
+ * These properties are determined from the IR without executing it. A
+ * program without result feedback applies the same sequence of quantum
+ * operations every shot; if in addition its measurements are terminal, all
+ * shots can be sampled from a single simulation.
+ */
+struct ModuleAnalysis
+{
+    //! Number of basic blocks in the entry point and functions it calls
+    size_type num_blocks{};
+    //! Control flow has conditional branches
+    bool has_branches{};
+    //! Control flow has a cycle
+    bool has_loops{};
+    //! Functions defined in the module (or unknown functions) are called
+    bool has_internal_calls{};
+    //! Program is a single basic block with no internal calls
+    bool straight_line{};
+    //! Number of measurement instructions
+    size_type num_measurements{};
+    //! Straight-line program applies no operations after its first measurement
+    bool terminal_measurements{};
+    //! Measured results are read by the program (e.g., with read_result)
+    bool reads_results{};
+    //! Values read from results affect control flow or other operations
+    bool result_feedback{};
+    //! Sorted names of quantum instruction set functions that are called
+    std::vector<std::string> qis_functions;
+};
+
 //---------------------------------------------------------------------------//
 // ENUMERATIONS
 //---------------------------------------------------------------------------//
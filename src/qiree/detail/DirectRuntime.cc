@@ -0,0 +1,334 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/DirectRuntime.cc
+//---------------------------------------------------------------------------//
+#include "DirectRuntime.hh"
+
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Transforms/IPO/AlwaysInliner.h>
+#include <llvm/Transforms/Scalar/EarlyCSE.h>
+#include <llvm/Transforms/Scalar/SimplifyCFG.h>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using OpCode = OpTape::OpCode;
+using Op = OpTape::Op;
+
+static_assert(std::is_standard_layout_v<Op>,
+              "operation layout must be known to generated code");
+static_assert(std::is_standard_layout_v<DirectBuffer>,
+              "buffer layout must be known to generated code");
+
+//---------------------------------------------------------------------------//
+/*!
+ * QIR function that can be replaced by writing an operation to the buffer.
+ *
+ * Each character of \c params describes one argument: \c 'i' is a qubit,
+ * result, or size stored in the next element of \c Op::args ; \c 'a' is the
+ * rotation angle; \c 'p' is the Pauli basis; and \c 'l' is the output label.
+ */
+struct DirectFunction
+{
+    char const* name;
+    OpCode code;
+    char const* params;
+};
+
+constexpr DirectFunction direct_functions[] = {
+    // Runtime
+    {"__quantum__rt__initialize", OpCode::initialize, "l"},
+    {"__quantum__rt__array_record_output", OpCode::array_record_output, "il"},
+    {"__quantum__rt__tuple_record_output", OpCode::tuple_record_output, "il"},
+    {"__quantum__rt__result_record_output", OpCode::result_record_output, "il"},
+    // Measurements
+    {"__quantum__qis__mz__body", OpCode::mz, "ii"},
+    // Gates
+    {"__quantum__qis__ccx__body", OpCode::ccx, "iii"},
+    {"__quantum__qis__cnot__body", OpCode::cnot, "ii"},
+    {"__quantum__qis__cx__body", OpCode::cx, "ii"},
+    {"__quantum__qis__cy__body", OpCode::cy, "ii"},
+    {"__quantum__qis__cz__body", OpCode::cz, "ii"},
+    {"__quantum__qis__h__body", OpCode::h, "i"},
+    {"__quantum__qis__r__body", OpCode::r, "pai"},
+    {"__quantum__qis__r__adj", OpCode::r_adj, "pai"},
+    {"__quantum__qis__reset__body", OpCode::reset, "i"},
+    {"__quantum__qis__rx__body", OpCode::rx, "ai"},
+    {"__quantum__qis__rxx__body", OpCode::rxx, "aii"},
+    {"__quantum__qis__ry__body", OpCode::ry, "ai"},
+    {"__quantum__qis__ryy__body", OpCode::ryy, "aii"},
+    {"__quantum__qis__rz__body", OpCode::rz, "ai"},
+    {"__quantum__qis__rzz__body", OpCode::rzz, "aii"},
+    {"__quantum__qis__s__body", OpCode::s, "i"},
+    {"__quantum__qis__s__adj", OpCode::s_adj, "i"},
+    {"__quantum__qis__swap__body", OpCode::swap, "ii"},
+    {"__quantum__qis__t__body", OpCode::t, "i"},
+    {"__quantum__qis__t__adj", OpCode::t_adj, "i"},
+    {"__quantum__qis__x__body", OpCode::x, "i"},
+    {"__quantum__qis__y__body", OpCode::y, "i"},
+    {"__quantum__qis__z__body", OpCode::z, "i"},
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a declaration has the argument types expected for its operation.
+ */
+bool matches(llvm::Function const& f, char const* params)
+{
+    if (!f.getReturnType()->isVoidTy()
+        || f.arg_size() != std::strlen(params))
+    {
+        return false;
+    }
+    for (llvm::Argument const& arg : f.args())
+    {
+        llvm::Type const* t = arg.getType();
+        char const p = params[arg.getArgNo()];
+        bool const ok = (p == 'i' && (t->isPointerTy() || t->isIntegerTy()))
+                        || (p == 'a' && t->isDoubleTy())
+                        || (p == 'p' && t->isIntegerTy())
+                        || (p == 'l' && t->isPointerTy());
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Emit IR that writes to the buffer.
+ */
+class BufferWriter
+{
+  public:
+    explicit BufferWriter(llvm::Module& mod);
+
+    // Define a function as a buffer write
+    void define(llvm::Function& f, DirectFunction const& df);
+
+  private:
+    llvm::LLVMContext& ctx_;
+    llvm::Type* ptr_type_;
+    llvm::Function* get_buffer_;
+    llvm::Function* flush_;
+
+    // Get a typed pointer to a field at a byte offset
+    llvm::Value* field(llvm::IRBuilder<>& b,
+                       llvm::Value* base,
+                       std::size_t offset,
+                       llvm::Type* type) const;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Declare the host functions.
+ */
+BufferWriter::BufferWriter(llvm::Module& mod)
+    : ctx_{mod.getContext()}
+    , ptr_type_{llvm::Type::getInt8Ty(ctx_)->getPointerTo()}
+    , get_buffer_{llvm::Function::Create(
+          llvm::FunctionType::get(ptr_type_, /* vararg = */ false),
+          llvm::GlobalValue::ExternalLinkage,
+          direct_buffer_name,
+          mod)}
+    , flush_{llvm::Function::Create(
+          llvm::FunctionType::get(llvm::Type::getVoidTy(ctx_),
+                                  /* vararg = */ false),
+          llvm::GlobalValue::ExternalLinkage,
+          direct_flush_name,
+          mod)}
+{
+    // The buffer address is fixed for each thread, so calls to get it can
+    // be combined
+    get_buffer_->setDoesNotAccessMemory();
+    get_buffer_->setDoesNotThrow();
+    get_buffer_->setWillReturn();
+
+    // The buffer is rarely full
+    flush_->addFnAttr(llvm::Attribute::Cold);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Define a function as a buffer write.
+ *
+ * The definition is internal and always inlined, so that after inlining the
+ * declaration disappears from the module.
+ */
+void BufferWriter::define(llvm::Function& f, DirectFunction const& df)
+{
+    f.setLinkage(llvm::GlobalValue::InternalLinkage);
+    f.addFnAttr(llvm::Attribute::AlwaysInline);
+
+    auto* entry = llvm::BasicBlock::Create(ctx_, "entry", &f);
+    auto* flush = llvm::BasicBlock::Create(ctx_, "flush", &f);
+    auto* write = llvm::BasicBlock::Create(ctx_, "write", &f);
+    llvm::IRBuilder<> b{entry};
+
+    // Flush if the buffer is full
+    llvm::Value* buf = b.CreateCall(get_buffer_);
+    auto* pos_ptr = this->field(b, buf, offsetof(DirectBuffer, pos), ptr_type_);
+    auto* pos = b.CreateLoad(ptr_type_, pos_ptr);
+    auto* end = b.CreateLoad(
+        ptr_type_,
+        this->field(b, buf, offsetof(DirectBuffer, end), ptr_type_));
+    b.CreateCondBr(b.CreateICmpEQ(pos, end), flush, write);
+
+    b.SetInsertPoint(flush);
+    b.CreateCall(flush_);
+    auto* flushed_pos = b.CreateLoad(ptr_type_, pos_ptr);
+    b.CreateBr(write);
+
+    // Write the operation code and arguments
+    b.SetInsertPoint(write);
+    auto* op = b.CreatePHI(ptr_type_, 2);
+    op->addIncoming(pos, entry);
+    op->addIncoming(flushed_pos, flush);
+
+    auto* i8 = b.getInt8Ty();
+    auto* i64 = b.getInt64Ty();
+    b.CreateStore(llvm::ConstantInt::get(i8, static_cast<int>(df.code)),
+                  this->field(b, op, offsetof(Op, code), i8));
+    std::size_t num_args = 0;
+    for (llvm::Argument& arg : f.args())
+    {
+        llvm::Value* value = &arg;
+        switch (df.params[arg.getArgNo()])
+        {
+            case 'i':
+                value = value->getType()->isPointerTy()
+                            ? b.CreatePtrToInt(value, i64)
+                            : b.CreateZExtOrTrunc(value, i64);
+                b.CreateStore(value,
+                              this->field(b,
+                                          op,
+                                          offsetof(Op, args)
+                                              + num_args++ * sizeof(size_type),
+                                          i64));
+                break;
+            case 'a':
+                b.CreateStore(
+                    value,
+                    this->field(b, op, offsetof(Op, angle), b.getDoubleTy()));
+                break;
+            case 'p':
+                b.CreateStore(b.CreateZExtOrTrunc(value, i8),
+                              this->field(b, op, offsetof(Op, pauli), i8));
+                break;
+            case 'l':
+                b.CreateStore(
+                    b.CreatePointerCast(value, ptr_type_),
+                    this->field(b, op, offsetof(Op, label), ptr_type_));
+                break;
+            default:
+                QIREE_ASSERT_UNREACHABLE();
+        }
+    }
+
+    // Advance to the next operation
+    b.CreateStore(b.CreateConstInBoundsGEP1_64(i8, op, sizeof(Op)), pos_ptr);
+    b.CreateRetVoid();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a typed pointer to a field at a byte offset.
+ */
+llvm::Value* BufferWriter::field(llvm::IRBuilder<>& b,
+                                 llvm::Value* base,
+                                 std::size_t offset,
+                                 llvm::Type* type) const
+{
+    llvm::Value* result = base;
+    if (offset != 0)
+    {
+        result = b.CreateConstInBoundsGEP1_64(b.getInt8Ty(), base, offset);
+    }
+    return b.CreatePointerCast(result, type->getPointerTo());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Define simple QIR functions as buffer writes and inline them.
+ *
+ * Each declared quantum or runtime function that only applies an operation to
+ * qubits and results (see \c OpTape ) is defined as a write to the calling
+ * thread's \c DirectBuffer . The definitions are inlined and cleaned up so
+ * that each call becomes a capacity check and a few stores. Operations that
+ * return a value or use arrays, tuples, or strings are still bound to the
+ * host; the host must apply buffered operations before executing them.
+ *
+ * The number of functions defined is returned.
+ */
+size_type define_direct_runtime(llvm::Module& mod)
+{
+    std::optional<BufferWriter> write;
+    size_type result = 0;
+    for (DirectFunction const& df : direct_functions)
+    {
+        llvm::Function* f = mod.getFunction(df.name);
+        if (!f || !f->isDeclaration() || !matches(*f, df.params))
+        {
+            continue;
+        }
+        if (!write)
+        {
+            write.emplace(mod);
+        }
+        write->define(*f, df);
+        ++result;
+    }
+    if (result == 0)
+    {
+        return result;
+    }
+
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+    llvm::PassBuilder pb;
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    // Inline the definitions, then reuse the buffer address and position
+    // between consecutive writes
+    llvm::FunctionPassManager fpm;
+    fpm.addPass(llvm::EarlyCSEPass{});
+    fpm.addPass(llvm::SimplifyCFGPass{});
+    llvm::ModulePassManager mpm;
+    mpm.addPass(llvm::AlwaysInlinerPass{});
+    mpm.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(fpm)));
+    mpm.run(mod, mam);
+
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,49 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/DirectRuntime.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include "qiree/OpTape.hh"
+#include "qiree/Types.hh"
+
+namespace llvm
+{
+class Module;
+}
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Per-thread buffer of operations enqueued by compiled QIR code.
+ *
+ * Compiled code writes each operation at \c pos and advances it, calling the
+ * flush function first if the buffer is full. The host applies the
+ * operations in <code>[begin, pos)</code> to the interfaces and resets \c pos
+ * to \c begin .
+ */
+struct DirectBuffer
+{
+    OpTape::Op* pos{nullptr};
+    OpTape::Op* end{nullptr};
+    OpTape::Op* begin{nullptr};
+};
+
+//! Name of the host function returning the calling thread's buffer
+inline constexpr char direct_buffer_name[] = "__qiree_direct_buffer";
+
+//! Name of the host function applying and removing buffered operations
+inline constexpr char direct_flush_name[] = "__qiree_direct_flush";
+
+// Define simple QIR functions as buffer writes and inline them
+size_type define_direct_runtime(llvm::Module& mod);
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -8,7 +8,9 @@
 #pragma once
 
 #include <type_traits>
-#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/Mangling.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
 
@@ -22,12 +24,17 @@ namespace detail
 //---------------------------------------------------------------------------//
 /*!
  * Map IR functions to compiled functions.
+ *
+ * Each function declared in the module is checked against the signature of
+ * its C++ implementation and added to a map of absolute JIT symbols.
  */
 class GlobalMapper
 {
   public:
-    // Construct with module and engine
-    inline GlobalMapper(llvm::Module const& mod, llvm::ExecutionEngine* ee);
+    // Construct with module, symbol mangler, and output symbols
+    inline GlobalMapper(llvm::Module const& mod,
+                        llvm::orc::MangleAndInterner& mangle,
+                        llvm::orc::SymbolMap& symbols);
 
     // Map a symbol name to a compiled function pointer
     template<class F>
@@ -35,7 +42,8 @@ class GlobalMapper
 
   private:
     llvm::Module const& mod_;
-    llvm::ExecutionEngine* ee_;
+    llvm::orc::MangleAndInterner& mangle_;
+    llvm::orc::SymbolMap& symbols_;
 
     // Non-templated function checks
     inline void check_func(llvm::Function const& irfunc) const;
@@ -45,12 +53,13 @@ class GlobalMapper
 // INLINE DEFINITIONS
 //---------------------------------------------------------------------------//
 /*!
- * Construct with module and engine.
+ * Construct with module, symbol mangler, and output symbols.
  */
-GlobalMapper::GlobalMapper(llvm::Module const& mod, llvm::ExecutionEngine* ee)
-    : mod_{mod}, ee_{ee}
+GlobalMapper::GlobalMapper(llvm::Module const& mod,
+                           llvm::orc::MangleAndInterner& mangle,
+                           llvm::orc::SymbolMap& symbols)
+    : mod_{mod}, mangle_{mangle}, symbols_{symbols}
 {
-    QIREE_EXPECT(ee_);
 }
 
 //---------------------------------------------------------------------------//
@@ -73,7 +82,15 @@ void GlobalMapper::operator()(char const* name, F* func) const
     // Throw an assertion if the function types don't match
     FunctionChecker{*irfunc}(func);
 
-    return ee_->addGlobalMapping(irfunc, reinterpret_cast<void*>(func));
+    auto const flags = llvm::JITSymbolFlags::Exported
+                       | llvm::JITSymbolFlags::Callable;
+#if LLVM_VERSION_MAJOR >= 17
+    symbols_[mangle_(name)]
+        = {llvm::orc::ExecutorAddr::fromPtr(func), flags};
+#else
+    symbols_[mangle_(name)] = llvm::JITEvaluatedSymbol(
+        llvm::pointerToJITTargetAddress(func), flags);
+#endif
 }
 
 //---------------------------------------------------------------------------//
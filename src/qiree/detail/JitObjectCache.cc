@@ -0,0 +1,170 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/JitObjectCache.cc
+//---------------------------------------------------------------------------//
+#include "JitObjectCache.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+
+#include "qiree/Assert.hh"
+#include "qiree/AtomicWrite.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Version of the cache key, incremented if the generated code changes.
+ */
+constexpr char cache_version[] = "qiree-object-1";
+
+//---------------------------------------------------------------------------//
+/*!
+ * Hash a sequence of strings, separating them unambiguously.
+ */
+class KeyHasher
+{
+  public:
+    void operator()(llvm::StringRef s)
+    {
+        hash_.update(s);
+        hash_.update(llvm::ArrayRef<std::uint8_t>{0});
+    }
+
+    std::string finish()
+    {
+        llvm::MD5::MD5Result result;
+        hash_.final(result);
+        return std::string{result.digest().str()};
+    }
+
+  private:
+    llvm::MD5 hash_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a directory, module hash, and target.
+ */
+JitObjectCache::JitObjectCache(
+    std::string dir,
+    std::string const& module_hash,
+    llvm::orc::JITTargetMachineBuilder const& target)
+    : dir_{std::move(dir)}
+{
+    QIREE_EXPECT(!dir_.empty());
+    QIREE_EXPECT(!module_hash.empty());
+
+    // Hash everything shared by the partitions of the module
+    KeyHasher hash;
+    hash(cache_version);
+    hash(LLVM_VERSION_STRING);
+    hash(module_hash);
+    hash(target.getTargetTriple().str());
+    hash(target.getCPU());
+    hash(target.getFeatures().getString());
+    prefix_ = hash.finish();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Save a newly compiled object.
+ *
+ * The object is written to a uniquely named temporary file and then renamed,
+ * so that concurrent processes never see a partial object.
+ */
+void JitObjectCache::notifyObjectCompiled(llvm::Module const* mod,
+                                          llvm::MemoryBufferRef obj)
+{
+    QIREE_EXPECT(mod);
+    ++num_compiled_;
+    std::string const path = this->path(*mod);
+
+    if (auto ec = llvm::sys::fs::create_directories(dir_))
+    {
+        std::clog << "qiree: failed to create object cache directory '"
+                  << dir_ << "': " << ec.message() << std::endl;
+        return;
+    }
+
+    if (auto ec = write_atomic(
+            path, std::string_view{obj.getBufferStart(), obj.getBufferSize()}))
+    {
+        std::clog << "qiree: failed to write object cache file '" << path
+                  << "': " << ec.message() << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load a previously compiled object.
+ *
+ * A null result tells the engine to compile the module.
+ */
+std::unique_ptr<llvm::MemoryBuffer>
+JitObjectCache::getObject(llvm::Module const* mod)
+{
+    QIREE_EXPECT(mod);
+    auto buffer = llvm::MemoryBuffer::getFile(this->path(*mod));
+    if (!buffer)
+    {
+        return nullptr;
+    }
+    ++num_loaded_;
+    return std::move(*buffer);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the path of the cached object for a module.
+ *
+ * A partition is identified by the sorted names of the symbols it defines.
+ */
+std::string JitObjectCache::path(llvm::Module const& mod) const
+{
+    std::vector<llvm::StringRef> names;
+    for (llvm::GlobalValue const& gv : mod.global_values())
+    {
+        if (!gv.isDeclaration())
+        {
+            names.push_back(gv.getName());
+        }
+    }
+    std::sort(names.begin(), names.end());
+
+    KeyHasher hash;
+    hash(prefix_);
+    hash(mod.getModuleIdentifier());
+    for (auto const& name : names)
+    {
+        hash(name);
+    }
+
+    llvm::SmallString<256> result{dir_};
+    llvm::sys::path::append(result, hash.finish() + ".o");
+    return std::string{result.str()};
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
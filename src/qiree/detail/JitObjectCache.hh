@@ -0,0 +1,76 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/JitObjectCache.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+namespace llvm
+{
+namespace orc
+{
+class JITTargetMachineBuilder;
+}
+}  // namespace llvm
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Store objects compiled by the JIT in a directory.
+ *
+ * The JIT compiles a QIR module lazily as a series of partitions, each a
+ * small module holding one or more functions. The object for each partition
+ * is saved as \c <key>.o , where the key is a hash of the QIR module contents,
+ * the names of the partition's definitions, the LLVM version, and the target
+ * triple, CPU, and features. When the JIT later compiles the same partition
+ * for the same target, it loads the saved object instead of generating code.
+ *
+ * Failing to read or write a cached object is not an error: the partition is
+ * simply compiled again. The cache may be used by concurrent compile threads.
+ */
+class JitObjectCache final : public llvm::ObjectCache
+{
+  public:
+    // Construct with a directory, module hash, and target
+    JitObjectCache(std::string dir,
+                   std::string const& module_hash,
+                   llvm::orc::JITTargetMachineBuilder const& target);
+
+    // Save a newly compiled object
+    void notifyObjectCompiled(llvm::Module const* mod,
+                              llvm::MemoryBufferRef obj) final;
+
+    // Load a previously compiled object
+    std::unique_ptr<llvm::MemoryBuffer>
+    getObject(llvm::Module const* mod) final;
+
+    //! Number of objects loaded from the cache
+    std::size_t num_loaded() const { return num_loaded_; }
+
+    //! Number of newly compiled objects
+    std::size_t num_compiled() const { return num_compiled_; }
+
+  private:
+    std::string dir_;
+    std::string prefix_;
+    std::atomic<std::size_t> num_loaded_{0};
+    std::atomic<std::size_t> num_compiled_{0};
+
+    // Get the path of the cached object for a module
+    std::string path(llvm::Module const& mod) const;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
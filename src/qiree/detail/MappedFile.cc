@@ -0,0 +1,83 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/MappedFile.cc
+//---------------------------------------------------------------------------//
+#include "MappedFile.hh"
+
+#include <cerrno>
+#include <cstring>
+
+#include "qiree/Assert.hh"
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define QIREE_HAVE_MMAP 1
+#endif
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Map a file.
+ */
+MappedFile::MappedFile(std::string const& filename)
+{
+#ifdef QIREE_HAVE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    QIREE_VALIDATE(fd >= 0,
+                   << "failed to open '" << filename
+                   << "': " << std::strerror(errno));
+
+    struct stat info;
+    int err = ::fstat(fd, &info);
+    if (err == 0 && info.st_size > 0)
+    {
+        size_ = static_cast<std::size_t>(info.st_size);
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data_ == MAP_FAILED)
+        {
+            data_ = nullptr;
+            err = -1;
+        }
+        else
+        {
+            // Contents are read once from start to end
+            ::madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+    }
+    int const saved_errno = errno;
+    ::close(fd);
+    QIREE_VALIDATE(err == 0,
+                   << "failed to map '" << filename
+                   << "': " << std::strerror(saved_errno));
+#else
+    QIREE_DISCARD(filename);
+    QIREE_NOT_IMPLEMENTED("memory-mapped files on this platform");
+#endif
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Unmap the file.
+ */
+MappedFile::~MappedFile()
+{
+#ifdef QIREE_HAVE_MMAP
+    if (data_)
+    {
+        ::munmap(data_, size_);
+    }
+#endif
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
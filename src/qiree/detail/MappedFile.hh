@@ -0,0 +1,70 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/MappedFile.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Read-only memory map of a whole file.
+ *
+ * Pages are loaded by the operating system as they are accessed, so a file
+ * much larger than physical memory can be read sequentially. An empty file
+ * maps to a null pointer with zero size.
+ */
+class MappedFile
+{
+  public:
+    // Construct without a file
+    MappedFile() = default;
+
+    // Map a file
+    explicit MappedFile(std::string const& filename);
+
+    // Unmap the file
+    ~MappedFile();
+
+    //!@{
+    //! Move but do not copy
+    MappedFile(MappedFile&& other) noexcept { this->swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        MappedFile{std::move(other)}.swap(*this);
+        return *this;
+    }
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+    //!@}
+
+    //! Start of the file contents
+    char const* data() const { return static_cast<char const*>(data_); }
+
+    //! Size of the file in bytes
+    std::size_t size() const { return size_; }
+
+    //! Exchange with another mapping
+    void swap(MappedFile& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+  private:
+    void* data_{nullptr};
+    std::size_t size_{0};
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,211 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/PackedCountMap.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Open-addressing hash table of {packed bit key -> count}.
+ *
+ * Every key is a fixed number of 64-bit words. Keys and counts are stored in
+ * flat arrays with linear probing; a zero count marks an empty slot, so
+ * there is no separate occupancy array. The capacity is always a power of two
+ * and the table is rehashed when it becomes half full.
+ */
+class PackedCountMap
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Word = std::uint64_t;
+    using size_type = std::size_t;
+    //!@}
+
+  public:
+    // Construct with the number of words per key
+    explicit inline PackedCountMap(size_type num_words = 1);
+
+    // Add to the count for a key
+    inline void add(Word const* key, size_type count = 1);
+
+    // Find the count for a key, zero if not present
+    inline size_type find(Word const* key) const;
+
+    // Call a function for every (key, count) pair
+    template<class F>
+    inline void for_each(F&& visit) const;
+
+    //! Number of words per key
+    size_type num_words() const { return num_words_; }
+
+    //! Number of distinct keys
+    size_type size() const { return size_; }
+
+    //! Whether no keys are present
+    bool empty() const { return size_ == 0; }
+
+    //! Number of slots
+    size_type capacity() const { return counts_.size(); }
+
+    //! Key stored in a slot (only valid if the count is nonzero)
+    Word const* key_at(size_type slot) const
+    {
+        return keys_.data() + slot * num_words_;
+    }
+
+    //! Count stored in a slot (zero if empty)
+    size_type count_at(size_type slot) const { return counts_[slot]; }
+
+  private:
+    size_type num_words_;
+    size_type size_{0};
+    std::vector<Word> keys_;
+    std::vector<size_type> counts_;
+
+    inline size_type find_slot(Word const* key) const;
+    inline void rehash(size_type new_capacity);
+    static inline Word hash(Word const* key, size_type num_words);
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the number of words per key.
+ */
+PackedCountMap::PackedCountMap(size_type num_words) : num_words_{num_words}
+{
+    QIREE_EXPECT(num_words_ > 0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add to the count for a key.
+ */
+void PackedCountMap::add(Word const* key, size_type count)
+{
+    QIREE_EXPECT(count > 0);
+    if (QIREE_UNLIKELY(2 * (size_ + 1) > this->capacity()))
+    {
+        this->rehash(std::max<size_type>(16, 2 * this->capacity()));
+    }
+
+    size_type slot = this->find_slot(key);
+    if (counts_[slot] == 0)
+    {
+        std::copy(key, key + num_words_, keys_.begin() + slot * num_words_);
+        ++size_;
+    }
+    counts_[slot] += count;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Find the count for a key, zero if not present.
+ */
+auto PackedCountMap::find(Word const* key) const -> size_type
+{
+    if (this->empty())
+    {
+        return 0;
+    }
+    return counts_[this->find_slot(key)];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Call a function for every (key, count) pair.
+ *
+ * The function is called as \c visit(Word const* key, size_type count) .
+ */
+template<class F>
+void PackedCountMap::for_each(F&& visit) const
+{
+    for (size_type slot = 0; slot != counts_.size(); ++slot)
+    {
+        if (counts_[slot] != 0)
+        {
+            visit(this->key_at(slot), counts_[slot]);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Find the slot that holds the key, or the empty slot where it belongs.
+ */
+auto PackedCountMap::find_slot(Word const* key) const -> size_type
+{
+    QIREE_EXPECT(!counts_.empty());
+    size_type const mask = counts_.size() - 1;
+    size_type slot = hash(key, num_words_) & mask;
+    while (counts_[slot] != 0
+           && !std::equal(key,
+                          key + num_words_,
+                          keys_.begin() + slot * num_words_))
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reallocate and reinsert all elements.
+ */
+void PackedCountMap::rehash(size_type new_capacity)
+{
+    QIREE_EXPECT((new_capacity & (new_capacity - 1)) == 0);
+    std::vector<Word> old_keys(new_capacity * num_words_);
+    std::vector<size_type> old_counts(new_capacity);
+    keys_.swap(old_keys);
+    counts_.swap(old_counts);
+
+    for (size_type old_slot = 0; old_slot != old_counts.size(); ++old_slot)
+    {
+        if (old_counts[old_slot] != 0)
+        {
+            Word const* key = old_keys.data() + old_slot * num_words_;
+            size_type slot = this->find_slot(key);
+            std::copy(
+                key, key + num_words_, keys_.begin() + slot * num_words_);
+            counts_[slot] = old_counts[old_slot];
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Hash a packed key using the splitmix64 finalizer.
+ */
+auto PackedCountMap::hash(Word const* key, size_type num_words) -> Word
+{
+    Word result = 0;
+    for (size_type i = 0; i != num_words; ++i)
+    {
+        Word h = result ^ key[i];
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        result = h ^ (h >> 31);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
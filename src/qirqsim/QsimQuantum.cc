@@ -9,103 +9,246 @@
 #include "QsimQuantum.hh"
 
 #include <algorithm>
+#include <charconv>
 #include <iostream>
-#include <optional>
-#include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
 
 #include "qiree/Assert.hh"
 
-// Qsim
-#include <qsim/lib/circuit.h>
-#include <qsim/lib/circuit_qsim_parser.h>
-#include <qsim/lib/formux.h>
-#include <qsim/lib/fuser.h>
-#include <qsim/lib/fuser_mqubit.h>
-#include <qsim/lib/gate.h>
-#include <qsim/lib/gates_qsim.h>
-#include <qsim/lib/io.h>
-#include <qsim/lib/io_file.h>
-#include <qsim/lib/run_qsim.h>
-#include <qsim/lib/simmux.h>
-#include <qsim/lib/simulator_basic.h>
-#include <qsim/lib/statespace_basic.h>
-#include <qsim/lib/util_cpu.h>
-//
+#include "detail/QsimEngineImpl.hh"
+#include "detail/QsimKernel.hh"
+
+#ifdef __linux__
+#    include <pthread.h>
+#    include <sched.h>
+#endif
 
 namespace qiree
 {
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Largest gate fusion supported by qsim
+constexpr unsigned int max_max_fused_size = 6;
+
+//---------------------------------------------------------------------------//
+//! Instruction sets in order of preference
+constexpr QsimQuantum::Isa preferred_isas[] = {
+    QsimQuantum::Isa::avx512,
+    QsimQuantum::Isa::avx2,
+    QsimQuantum::Isa::sse4,
+    QsimQuantum::Isa::basic,
+};
+
 //---------------------------------------------------------------------------//
 /*!
- * Factory class for creating simulators in qsim.
+ * Whether the running CPU has the instructions for an instruction set.
+ *
+ * These match the compiler flags used for the corresponding kernels.
  */
-struct QsimQuantum::Factory
+bool cpu_supports(QsimQuantum::Isa isa)
 {
-    Factory(unsigned num_threads) : num_threads(num_threads) {}
-    using Simulator = qsim::Simulator<qsim::For>;
-    using StateSpace = Simulator::StateSpace;
+    using Isa = QsimQuantum::Isa;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    switch (isa)
+    {
+        case Isa::avx512:
+            return __builtin_cpu_supports("avx512f")
+                   && __builtin_cpu_supports("bmi2");
+        case Isa::avx2:
+            return __builtin_cpu_supports("avx2")
+                   && __builtin_cpu_supports("fma")
+                   && __builtin_cpu_supports("bmi2");
+        case Isa::sse4:
+            return __builtin_cpu_supports("sse4.1");
+        case Isa::basic:
+            return true;
+        default:
+            break;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+#else
+    return isa == Isa::basic;
+#endif
+}
 
-    StateSpace CreateStateSpace() const { return StateSpace(num_threads); }
-    Simulator CreateSimulator() const { return Simulator(num_threads); }
-    unsigned num_threads;
-};
+//---------------------------------------------------------------------------//
+/*!
+ * Create a single-precision kernel if the build supports it.
+ */
+std::unique_ptr<detail::QsimKernel<float>>
+make_kernel(QsimQuantum::Isa isa, unsigned int num_threads)
+{
+    using Isa = QsimQuantum::Isa;
+    switch (isa)
+    {
+        case Isa::avx512:
+            return detail::make_qsim_kernel_avx512(num_threads);
+        case Isa::avx2:
+            return detail::make_qsim_kernel_avx2(num_threads);
+        case Isa::sse4:
+            return detail::make_qsim_kernel_sse4(num_threads);
+        case Isa::basic:
+            return detail::make_qsim_kernel_basic(num_threads);
+        default:
+            break;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
 
 //---------------------------------------------------------------------------//
 /*!
- * Quantum state and circuit.
+ * Create a simulation engine with the requested precision and instructions.
  */
-struct QsimQuantum::State
+std::unique_ptr<detail::QsimEngine>
+make_engine(QsimQuantum::Options const& opts,
+            QsimQuantum::Isa isa,
+            unsigned long int seed)
 {
-    qsim::Circuit<qsim::GateQSim<float>> circuit;
-    std::optional<Factory::StateSpace::State> state;
-};
+    detail::QsimEngine::Params params;
+    params.num_threads = opts.num_threads;
+    params.max_fused_size = opts.max_fused_size;
+    params.seed = seed;
+
+    if (opts.precision == QsimQuantum::Precision::double_)
+    {
+        QIREE_ASSERT(isa == QsimQuantum::Isa::basic);
+        return std::make_unique<detail::QsimEngineImpl<double>>(
+            params, detail::make_qsim_kernel_basic_double(opts.num_threads));
+    }
+    auto kernel = make_kernel(isa, opts.num_threads);
+    QIREE_ASSERT(kernel);
+    return std::make_unique<detail::QsimEngineImpl<float>>(params,
+                                                           std::move(kernel));
+}
 
 //---------------------------------------------------------------------------//
 /*!
- * Initialize the qsim simulator
+ * Bind the calling thread to a range of CPUs.
+ *
+ * Threads created afterward by the calling thread (such as an OpenMP team)
+ * inherit the binding.
+ */
+void pin_thread(unsigned int first_cpu, unsigned int num_cpus)
+{
+#ifdef __linux__
+    unsigned int const num_available
+        = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (unsigned int i = 0; i < num_cpus; ++i)
+    {
+        CPU_SET((first_cpu + i) % num_available, &cpus);
+    }
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    QIREE_VALIDATE(err == 0,
+                   << "failed to bind thread to CPUs " << first_cpu << "-"
+                   << first_cpu + num_cpus - 1 << " (error " << err << ")");
+#else
+    QIREE_DISCARD(first_cpu);
+    QIREE_DISCARD(num_cpus);
+    QIREE_NOT_IMPLEMENTED("thread affinity on this platform");
+#endif
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Parse an unsigned integer option.
+ */
+unsigned int to_uint(std::string_view key, std::string_view value)
+{
+    unsigned int result{};
+    auto [ptr, ec]
+        = std::from_chars(value.data(), value.data() + value.size(), result);
+    QIREE_VALIDATE(ec == std::errc{} && ptr == value.data() + value.size(),
+                   << "invalid value '" << value << "' for qsim option '"
+                   << key << "': expected a nonnegative integer");
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+//! Convert a qubit ID to a qsim index
+unsigned int to_index(Qubit q)
+{
+    return static_cast<unsigned int>(q.value);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
  */
 QsimQuantum::QsimQuantum(std::ostream& os, unsigned long int seed)
-    : output_(os), seed_(seed), state_{std::make_unique<State>()}
+    : QsimQuantum{os, seed, Options{}}
 {
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ *
+ * A thread count of zero uses all available cores.
+ */
+QsimQuantum::QsimQuantum(std::ostream& os,
+                         unsigned long int seed,
+                         Options const& options)
+    : output_(os), options_{options}
+{
+    QIREE_VALIDATE(options_.max_fused_size > 0
+                       && options_.max_fused_size <= max_max_fused_size,
+                   << "invalid maximum fused gate size "
+                   << options_.max_fused_size << ": must be in [1, "
+                   << max_max_fused_size << "]");
+    if (options_.num_threads == 0)
+    {
+        options_.num_threads
+            = std::max(1u, std::thread::hardware_concurrency());
+    }
+    isa_ = select_isa(options_);
+    engine_ = make_engine(options_, isa_, seed);
+}
+
 //---------------------------------------------------------------------------//
 //! Default destructor
 QsimQuantum::~QsimQuantum() = default;
 
+//---------------------------------------------------------------------------//
+/*!
+ * Number of times a circuit has been simulated.
+ */
+size_type QsimQuantum::num_simulations() const
+{
+    return engine_->num_simulations();
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Prepare to build a quantum circuit for an entry point.
+ *
+ * If requested, the calling thread is bound to its CPUs the first time it
+ * calls this. Affinity belongs to the thread, not the simulator, so a
+ * simulator that is later driven from another thread binds that one too.
  */
 void QsimQuantum::set_up(EntryPointAttrs const& attrs)
 {
     QIREE_VALIDATE(attrs.required_num_qubits > 0,
                    << "input is not a quantum program");
 
-    // Resize the result_to_qubit_ vector, based on the required number of
-    // results... the idea is to have as many classical registers as qubits
-    // (probably not true in general)
-    results_.resize(attrs.required_num_results);
-    num_qubits_ = attrs.required_num_qubits;
-    num_threads_
-        = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
-
-    // Initialize the qsim simulator
-    auto state_space = Factory(num_threads_).CreateStateSpace();
+    if (options_.affinity == Affinity::compact
+        && pinned_thread_ != std::this_thread::get_id())
+    {
+        pin_thread(options_.first_cpu, options_.num_threads);
+        pinned_thread_ = std::this_thread::get_id();
+    }
 
-    // Create the state
-    state_->state = state_space.Create(this->num_qubits());
-    // Check if the state is null
-    QIREE_VALIDATE(!state_space.IsNull(*state_->state),
-                   << "not enough memory: is the number of qubits too large?");
-
-    // TODO: initial states shouldn't necessarily be zero
-    state_space.SetStateZero(*state_->state);
-
-    // Allocate the number of qubits in the circuit
-    state_->circuit.num_qubits = num_qubits_;
-    gate_index_ = 0;
+    num_qubits_ = attrs.required_num_qubits;
+    num_results_ = attrs.required_num_results;
+    engine_->set_up(num_qubits_, num_results_);
 }
 
 //---------------------------------------------------------------------------//
@@ -114,156 +257,359 @@ void QsimQuantum::set_up(EntryPointAttrs const& attrs)
  */
 void QsimQuantum::tear_down()
 {
-    state_->circuit = {};
+    engine_->tear_down();
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Reset the qubit
+ * Reset the qubit to |0>.
+ *
+ * This measures the qubit (triggering simulation) unless it is known to be in
+ * |0> already.
  */
 void QsimQuantum::reset(Qubit q)
 {
-    q.value = 0;
+    QIREE_EXPECT(q.value < this->num_qubits());
+    engine_->reset(to_index(q));
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Map a qubit to a result index.
+ * Measure a qubit into a result.
  *
- * (TODO: find how to link the classical register to the quantum register in
- * qsim)
+ * The measurement is deferred until the result is read or the qubit is used
+ * again.
  */
 void QsimQuantum::mz(Qubit q, Result r)
 {
     QIREE_EXPECT(q.value < this->num_qubits());
     QIREE_EXPECT(r.value < this->num_results());
-
-    // Add measurement instruction
-    state_->circuit.gates.push_back(
-        qsim::gate::Measurement<qsim::GateQSim<float>>::Create(
-            gate_index_++, {static_cast<unsigned int>(q.value)}));
-
-    //// EXECUTE CIRCUIT ////
-
-    using Fuser = qsim::MultiQubitGateFuser<qsim::IO, qsim::GateQSim<float>>;
-    using Runner = qsim::QSimRunner<qsim::IO, Fuser, Factory>;
-    using StateSpace = Factory::StateSpace;
-
-    // Vector to hold measurement results, this must be empty before running
-    std::vector<StateSpace::MeasurementResult> meas_results;
-    std::string stringResult;
-
-    Runner::Parameter qsimParam;  // Parameters for qsim
-    qsimParam.seed = seed_;
-    seed_++;
-    qsimParam.max_fused_size = 2;  // Set the maximum size of fused gates
-    qsimParam.verbosity = 0;  // see verbosity in run_qsim.h
-
-    // Run the simulation and check that it passed
-    bool const run_success = Runner::Run(qsimParam,
-                                         Factory(num_threads_),
-                                         state_->circuit,
-                                         *state_->state,
-                                         meas_results);
-    QIREE_ASSERT(run_success);
-    QIREE_VALIDATE(
-        meas_results.size() == 1 && meas_results[0].bitstring.size() == 1,
-        << "inconsistent measured results size (" << meas_results.size()
-        << "), bitstring size");
-
-    //// RESET CIRCUIT ////
-
-    state_->circuit = {};
-    state_->circuit.num_qubits = num_qubits_;
-
-    //// STORE RESULT ////
-
-    auto result = meas_results[0].bitstring[0];
-    QIREE_ASSERT(result == 0 || result == 1);
-
-    results_[r.value] = result;
+    engine_->mz(to_index(q), r.value);
 }
 
 //----------------------------------------------------------------------------//
 /*!
  * Read the value of a result.
  *
- * \todo We could add assertions to check that we actually measured into the
- * given result.
+ * This triggers simulation if any measurements are pending.
  */
 QState QsimQuantum::read_result(Result r) const
 {
-    QIREE_EXPECT(r.value < results_.size());
-    auto result_bool = static_cast<bool>(results_[r.value]);
-    return static_cast<QState>(result_bool);
+    QIREE_EXPECT(r.value < this->num_results());
+    return static_cast<QState>(engine_->read_result(r.value));
 }
 
 //---------------------------------------------------------------------------//
 //// Entangling gates ////
+void QsimQuantum::ccx(Qubit q1, Qubit q2, Qubit q3)
+{
+    engine_->add_gate(
+        {detail::QsimGate::ccx, {to_index(q1), to_index(q2), to_index(q3)}});
+}
 void QsimQuantum::cx(Qubit q1, Qubit q2)
 {
-    this->add_gate<qsim::GateCNot>(q1.value, q2.value);
+    engine_->add_gate({detail::QsimGate::cnot, {to_index(q1), to_index(q2)}});
 }
 void QsimQuantum::cnot(Qubit q1, Qubit q2)
 {
-    this->add_gate<qsim::GateCNot>(q1.value, q2.value);
+    engine_->add_gate({detail::QsimGate::cnot, {to_index(q1), to_index(q2)}});
+}
+void QsimQuantum::cy(Qubit q1, Qubit q2)
+{
+    engine_->add_gate({detail::QsimGate::cy, {to_index(q1), to_index(q2)}});
 }
 void QsimQuantum::cz(Qubit q1, Qubit q2)
 {
-    this->add_gate<qsim::GateCZ>(q1.value, q2.value);
+    engine_->add_gate({detail::QsimGate::cz, {to_index(q1), to_index(q2)}});
+}
+void QsimQuantum::swap(Qubit q1, Qubit q2)
+{
+    engine_->add_gate({detail::QsimGate::swap, {to_index(q1), to_index(q2)}});
 }
 
 //// Local gates ////
 void QsimQuantum::h(Qubit q)
 {
-    this->add_gate<qsim::GateHd>(q.value);
+    engine_->add_gate({detail::QsimGate::h, {to_index(q)}});
 }
 void QsimQuantum::s(Qubit q)
 {
-    this->add_gate<qsim::GateS>(q.value);
+    engine_->add_gate({detail::QsimGate::s, {to_index(q)}});
+}
+void QsimQuantum::s_adj(Qubit q)
+{
+    engine_->add_gate({detail::QsimGate::s_adj, {to_index(q)}});
 }
 void QsimQuantum::t(Qubit q)
 {
-    this->add_gate<qsim::GateT>(q.value);
+    engine_->add_gate({detail::QsimGate::t, {to_index(q)}});
+}
+void QsimQuantum::t_adj(Qubit q)
+{
+    engine_->add_gate({detail::QsimGate::t_adj, {to_index(q)}});
 }
 
 //// Pauli gates ////
 void QsimQuantum::x(Qubit q)
 {
-    this->add_gate<qsim::GateX>(q.value);
+    engine_->add_gate({detail::QsimGate::x, {to_index(q)}});
 }
 void QsimQuantum::y(Qubit q)
 {
-    this->add_gate<qsim::GateY>(q.value);
+    engine_->add_gate({detail::QsimGate::y, {to_index(q)}});
 }
 void QsimQuantum::z(Qubit q)
 {
-    this->add_gate<qsim::GateZ>(q.value);
+    engine_->add_gate({detail::QsimGate::z, {to_index(q)}});
 }
 
 //// Rotation gates ////
 void QsimQuantum::rx(double theta, Qubit q)
 {
-    this->add_gate<qsim::GateRX>(q.value, theta);
+    engine_->add_gate({detail::QsimGate::rx, {to_index(q)}, theta});
 }
 void QsimQuantum::ry(double theta, Qubit q)
 {
-    this->add_gate<qsim::GateRY>(q.value, theta);
+    engine_->add_gate({detail::QsimGate::ry, {to_index(q)}, theta});
 }
 void QsimQuantum::rz(double theta, Qubit q)
 {
-    this->add_gate<qsim::GateRZ>(q.value, theta);
+    engine_->add_gate({detail::QsimGate::rz, {to_index(q)}, theta});
+}
+void QsimQuantum::rxx(double theta, Qubit q1, Qubit q2)
+{
+    engine_->add_gate(
+        {detail::QsimGate::rxx, {to_index(q1), to_index(q2)}, theta});
+}
+void QsimQuantum::ryy(double theta, Qubit q1, Qubit q2)
+{
+    engine_->add_gate(
+        {detail::QsimGate::ryy, {to_index(q1), to_index(q2)}, theta});
+}
+void QsimQuantum::rzz(double theta, Qubit q1, Qubit q2)
+{
+    engine_->add_gate(
+        {detail::QsimGate::rzz, {to_index(q1), to_index(q2)}, theta});
 }
 
-//----------------------------------------------------------------------------//
-// PRIVATE HELPERS
-//----------------------------------------------------------------------------//
-//! Create a gate and add it to the circuit
-template<template<class> class Gate, class... Ts>
-void QsimQuantum::add_gate(Ts&&... args)
+//---------------------------------------------------------------------------//
+/*!
+ * Rotate about a Pauli axis.
+ *
+ * A rotation about the identity is a global phase and has no effect.
+ */
+void QsimQuantum::r(Pauli pauli, double theta, Qubit q)
+{
+    switch (pauli)
+    {
+        case Pauli::i:
+            return;
+        case Pauli::x:
+            return this->rx(theta, q);
+        case Pauli::y:
+            return this->ry(theta, q);
+        case Pauli::z:
+            return this->rz(theta, q);
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Rotate about a Pauli axis in the opposite direction.
+ */
+void QsimQuantum::r_adj(Pauli pauli, double theta, Qubit q)
+{
+    this->r(pauli, -theta, q);
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string corresponding to an affinity policy.
+ */
+char const* to_cstring(QsimQuantum::Affinity value)
+{
+    switch (value)
+    {
+        case QsimQuantum::Affinity::none:
+            return "none";
+        case QsimQuantum::Affinity::compact:
+            return "compact";
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string corresponding to a precision.
+ */
+char const* to_cstring(QsimQuantum::Precision value)
+{
+    switch (value)
+    {
+        case QsimQuantum::Precision::single:
+            return "single";
+        case QsimQuantum::Precision::double_:
+            return "double";
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string corresponding to an instruction set.
+ */
+char const* to_cstring(QsimQuantum::Isa value)
+{
+    switch (value)
+    {
+        case QsimQuantum::Isa::automatic:
+            return "auto";
+        case QsimQuantum::Isa::avx512:
+            return "avx512";
+        case QsimQuantum::Isa::avx2:
+            return "avx2";
+        case QsimQuantum::Isa::sse4:
+            return "sse4";
+        case QsimQuantum::Isa::basic:
+            return "basic";
+        default:
+            break;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Choose the instruction set for a simulator.
+ *
+ * The automatic selection is the first of AVX-512, AVX2, SSE4.1, and basic
+ * that is supported by both the running CPU and the compiler that built this
+ * library. An explicitly requested instruction set must be available.
+ */
+QsimQuantum::Isa select_isa(QsimQuantum::Options const& options)
+{
+    using Isa = QsimQuantum::Isa;
+    auto is_available = [](Isa isa) {
+        return cpu_supports(isa) && make_kernel(isa, 1) != nullptr;
+    };
+
+    if (options.precision == QsimQuantum::Precision::double_)
+    {
+        QIREE_VALIDATE(
+            options.isa == Isa::automatic || options.isa == Isa::basic,
+            << "qsim instruction set '" << to_cstring(options.isa)
+            << "' is only available in single precision");
+        return Isa::basic;
+    }
+    if (options.isa != Isa::automatic)
+    {
+        QIREE_VALIDATE(is_available(options.isa),
+                       << "qsim instruction set '" << to_cstring(options.isa)
+                       << "' is not supported by this CPU or build");
+        return options.isa;
+    }
+    for (Isa isa : preferred_isas)
+    {
+        if (is_available(isa))
+        {
+            return isa;
+        }
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the options for one of several simulators sharing the cores.
+ *
+ * Unless the number of threads per simulator is specified, the cores are
+ * divided evenly among the workers (all cores if \c num_workers is zero).
+ * Each worker's CPUs start after those of the previous worker, so that
+ * with compact affinity the simulators do not share cores.
+ */
+QsimQuantum::Options worker_options(QsimQuantum::Options options,
+                                    unsigned int worker,
+                                    unsigned int num_workers)
+{
+    if (options.num_threads == 0)
+    {
+        unsigned int const num_cores
+            = std::max(1u, std::thread::hardware_concurrency());
+        options.num_threads
+            = std::max(1u, num_cores / (num_workers ? num_workers : num_cores));
+    }
+    options.first_cpu += worker * options.num_threads;
+    return options;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Set a simulation option from its name and a string value.
+ *
+ * This is used by front ends that read options from text (command line or
+ * JSON). The keys are the \c QsimQuantum::Options member names, and the
+ * enumerations use the strings from \c to_cstring .
+ */
+void set_option(QsimQuantum::Options& options,
+                std::string_view key,
+                std::string_view value)
 {
-    state_->circuit.gates.push_back(
-        Gate<float>::Create(gate_index_++, std::forward<Ts>(args)...));
+    if (key == "max_fused_size")
+    {
+        options.max_fused_size = to_uint(key, value);
+    }
+    else if (key == "num_threads")
+    {
+        options.num_threads = to_uint(key, value);
+    }
+    else if (key == "first_cpu")
+    {
+        options.first_cpu = to_uint(key, value);
+    }
+    else if (key == "affinity")
+    {
+        using Affinity = QsimQuantum::Affinity;
+        QIREE_VALIDATE(value == to_cstring(Affinity::none)
+                           || value == to_cstring(Affinity::compact),
+                       << "invalid qsim affinity '" << value
+                       << "': expected 'none' or 'compact'");
+        options.affinity = (value == to_cstring(Affinity::none))
+                               ? Affinity::none
+                               : Affinity::compact;
+    }
+    else if (key == "precision")
+    {
+        using Precision = QsimQuantum::Precision;
+        QIREE_VALIDATE(value == to_cstring(Precision::single)
+                           || value == to_cstring(Precision::double_),
+                       << "invalid qsim precision '" << value
+                       << "': expected 'single' or 'double'");
+        options.precision = (value == to_cstring(Precision::single))
+                                ? Precision::single
+                                : Precision::double_;
+    }
+    else if (key == "isa")
+    {
+        using Isa = QsimQuantum::Isa;
+        auto i = static_cast<std::size_t>(Isa::automatic);
+        auto const end = static_cast<std::size_t>(Isa::size_);
+        while (i != end && value != to_cstring(static_cast<Isa>(i)))
+        {
+            ++i;
+        }
+        QIREE_VALIDATE(i != end,
+                       << "invalid qsim instruction set '" << value
+                       << "': expected 'auto', 'avx512', 'avx2', 'sse4', "
+                          "or 'basic'");
+        options.isa = static_cast<Isa>(i);
+    }
+    else
+    {
+        QIREE_VALIDATE(false, << "unknown qsim option '" << key << "'");
+    }
 }
 
 }  // namespace qiree
@@ -7,8 +7,11 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <ostream>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 #include "qiree/Assert.hh"
@@ -19,15 +22,106 @@
 
 namespace qiree
 {
+//---------------------------------------------------------------------------//
+namespace detail
+{
+class QsimEngine;
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Create and execute quantum circuits using google Qsim.
+ *
+ * Every gate of the quantum interface that acts on individual qubits (rather
+ * than QIR arrays) maps to a native qsim gate: Toffoli and controlled-Y use
+ * qsim control qubits, and the two-qubit Pauli rotations are dense 4x4
+ * matrices. Reset measures the qubit
+ * and flips it if it was found in |1>.
+ *
+ * Gates are accumulated into a circuit and applied to the state vector in
+ * fused blocks whenever enough of them are pending. Measurements are deferred
+ * until a result is read or a measured qubit is acted upon. At that point the
+ * remaining gates are applied and the pending measurements are sampled
+ * together; the outcome is applied by collapsing the state vector. The cost
+ * of a mid-circuit measurement is thus proportional to the number of gates
+ * since the previous one.
+ *
+ * If a shot's only measurements come at the end of the program (i.e., there
+ * is a single batch of measurements and no gates follow it), the final state
+ * vector is kept. When later shots build an identical circuit, results are
+ * drawn from that state without re-simulating. Samples are taken in batches
+ * of increasing size with a single pass over the state vector, so running \em
+ * N shots of such a circuit costs one simulation and \em O(log N) sampling
+ * passes.
+ *
+ * The qsim state space and the state vector persist for the lifetime of this
+ * object. Each shot reinitializes the state vector in place, and it is only
+ * reallocated if the number of qubits changes.
+ *
+ * The vector instruction set used by the simulator is chosen when the
+ * object is constructed: unless one is requested in the options, it is the
+ * widest one that both this build and the running CPU support. Double
+ * precision always uses the basic (scalar) simulator.
+ *
+ * The simulation is configured with \c Options at construction. When running
+ * several simulators concurrently (e.g., one per \c ShotScheduler worker),
+ * the number of threads per simulator should be reduced accordingly, and each
+ * simulator can be pinned to its own range of CPUs.
  */
 class QsimQuantum final : virtual public QuantumNotImpl
 {
   public:
-    // Construct with number of shots
+    //! Policy for binding simulator threads to CPUs
+    enum class Affinity
+    {
+        none,  //!< Let the operating system schedule threads
+        compact,  //!< Pin to consecutive CPUs starting at \c first_cpu
+    };
+
+    //! Floating point precision of the state vector
+    enum class Precision
+    {
+        single,  //!< 32-bit floats (vectorized)
+        double_,  //!< 64-bit floats (basic simulator only)
+    };
+
+    //! Vector instruction set used by the simulator
+    enum class Isa
+    {
+        automatic,  //!< Widest available at run time
+        avx512,  //!< AVX-512F
+        avx2,  //!< AVX2 and FMA
+        sse4,  //!< SSE4.1
+        basic,  //!< No vector instructions
+        size_
+    };
+
+    //! Simulation options
+    struct Options
+    {
+        //! Maximum number of qubits in a fused gate [1, 6]
+        unsigned int max_fused_size{2};
+        //! Number of threads used by the simulator (zero for all cores)
+        unsigned int num_threads{0};
+        //! CPU binding policy for the thread that runs shots
+        Affinity affinity{Affinity::none};
+        //! First logical CPU used when pinning
+        unsigned int first_cpu{0};
+        //! State vector precision
+        Precision precision{Precision::single};
+        //! Instruction set
+        Isa isa{Isa::automatic};
+    };
+
+  public:
+    // Construct with an output stream and random seed
     QsimQuantum(std::ostream& os, unsigned long int seed);
+
+    // Construct with an output stream, random seed, and options
+    QsimQuantum(std::ostream& os,
+                unsigned long int seed,
+                Options const& options);
+
     ~QsimQuantum();
 
     QIREE_DELETE_COPY_MOVE(QsimQuantum);  // Delete copy and move constructors
@@ -39,7 +133,16 @@ class QsimQuantum final : virtual public QuantumNotImpl
     size_type num_qubits() const { return num_qubits_; }
 
     //! Number of classical result registers
-    size_type num_results() const { return results_.size(); }
+    size_type num_results() const { return num_results_; }
+
+    // Number of times a circuit has been simulated
+    size_type num_simulations() const;
+
+    //! Simulation options
+    Options const& options() const { return options_; }
+
+    //! Instruction set selected at construction
+    Isa isa() const { return isa_; }
 
     //!@}
 
@@ -60,52 +163,68 @@ class QsimQuantum final : virtual public QuantumNotImpl
 
     //!@{
     //! \name Circuit construction
-    // void ccx(Qubit, Qubit) final;
-    void ccnot(Qubit, Qubit, Qubit);  // TODO: not in examples or qir runner
+    void ccx(Qubit, Qubit, Qubit) final;
     void cnot(Qubit, Qubit) final;
     void cx(Qubit, Qubit) final;
-    // void cy(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
     void cz(Qubit, Qubit) final;
     void h(Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
     void reset(Qubit) final;
     void rx(double, Qubit) final;
+    void rxx(double, Qubit, Qubit) final;
     void ry(double, Qubit) final;
+    void ryy(double, Qubit, Qubit) final;
     void rz(double, Qubit) final;
-    // void rzz(double, Qubit, Qubit) final;
+    void rzz(double, Qubit, Qubit) final;
     void s(Qubit) final;
-    // void s_adj(Qubit) final;
-    // void swap(Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void swap(Qubit, Qubit) final;
     void t(Qubit) final;
-    // void t_adj(Qubit) final;
+    void t_adj(Qubit) final;
     void x(Qubit) final;
     void y(Qubit) final;
     void z(Qubit) final;
     //!@}
 
-    //
-
   private:
-    //// TYPES ////
-
-    struct Factory;
-    struct State;
-
     //// DATA ////
 
     std::ostream& output_;
-    unsigned long int seed_{};
-    std::unique_ptr<State> state_;
-    std::vector<bool> results_;
-
-    unsigned num_threads_{};  // Number of threads to use
-    size_t gate_index_;  // when the quantum operation will be executed
+    Options options_;
+    Isa isa_{Isa::automatic};
+    std::unique_ptr<detail::QsimEngine> engine_;
     size_type num_qubits_{};
-    std::vector<Qubit> result_to_qubit_;
+    size_type num_results_{};
+    std::thread::id pinned_thread_;
+};
 
-    //// HELPER FUNCTIONS ////
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
 
-    template<template<class> class Gate, class... Ts>
-    void add_gate(Ts&&... args);
-};
+// Get a string corresponding to an affinity policy
+char const* to_cstring(QsimQuantum::Affinity);
 
+// Get a string corresponding to a precision
+char const* to_cstring(QsimQuantum::Precision);
+
+// Get a string corresponding to an instruction set
+char const* to_cstring(QsimQuantum::Isa);
+
+// Choose the instruction set for a simulator
+QsimQuantum::Isa select_isa(QsimQuantum::Options const&);
+
+// Get the options for one of several simulators sharing the cores
+QsimQuantum::Options worker_options(QsimQuantum::Options options,
+                                    unsigned int worker,
+                                    unsigned int num_workers);
+
+// Set a simulation option from its name and a string value
+void set_option(QsimQuantum::Options& options,
+                std::string_view key,
+                std::string_view value);
+
+//---------------------------------------------------------------------------//
 }  // namespace qiree
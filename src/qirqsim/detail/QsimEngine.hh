@@ -0,0 +1,107 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimEngine.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+//! Gate type applied by a qsim engine
+enum class QsimGate
+{
+    ccx,
+    cnot,
+    cy,
+    cz,
+    h,
+    rx,
+    rxx,
+    ry,
+    ryy,
+    rz,
+    rzz,
+    s,
+    s_adj,
+    swap,
+    t,
+    t_adj,
+    x,
+    y,
+    z,
+    size_
+};
+
+//---------------------------------------------------------------------------//
+//! Gate and its arguments, independent of the simulator precision
+struct QsimOp
+{
+    QsimGate gate{QsimGate::size_};
+    std::array<unsigned int, 3> qubits{};
+    double angle{0};
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate a circuit with a particular qsim simulator.
+ *
+ * The qsim state space, simulator, and gate types depend on the floating
+ * point precision and instruction set, so they are hidden behind this
+ * interface. \c QsimQuantum forwards gates and measurements to it.
+ */
+class QsimEngine
+{
+  public:
+    //! Construction parameters
+    struct Params
+    {
+        unsigned int num_threads{1};
+        unsigned int max_fused_size{2};
+        unsigned long int seed{0};
+    };
+
+  public:
+    virtual ~QsimEngine() = default;
+
+    // Prepare for a new shot
+    virtual void set_up(size_type num_qubits, size_type num_results) = 0;
+
+    // Complete a shot
+    virtual void tear_down() = 0;
+
+    // Add a gate to the circuit
+    virtual void add_gate(QsimOp const& op) = 0;
+
+    // Measure a qubit into a result (deferred)
+    virtual void mz(unsigned int qubit, size_type result) = 0;
+
+    // Measure a qubit and flip it back to |0> if needed
+    virtual void reset(unsigned int qubit) = 0;
+
+    // Simulate if needed and read the value of a result
+    virtual bool read_result(size_type result) = 0;
+
+    // Number of times a circuit has been simulated
+    virtual size_type num_simulations() const = 0;
+
+    // Name of the instruction set used by the simulator
+    virtual char const* isa() const = 0;
+
+  protected:
+    QsimEngine() = default;
+    QsimEngine(QsimEngine const&) = default;
+    QsimEngine& operator=(QsimEngine const&) = default;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,702 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimEngineImpl.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "qiree/Assert.hh"
+
+#include "QsimEngine.hh"
+#include "QsimKernel.hh"
+
+// Qsim
+#include <qsim/lib/circuit.h>
+#include <qsim/lib/fuser.h>
+#include <qsim/lib/fuser_mqubit.h>
+#include <qsim/lib/gate.h>
+#include <qsim/lib/gates_qsim.h>
+#include <qsim/lib/io.h>
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate circuits with qsim at a given floating point precision.
+ *
+ * Gates are accumulated into a circuit and applied to the state vector in
+ * fused blocks whenever enough of them are pending. Measurements are deferred
+ * until a result is read or a measured qubit is acted upon. At that point the
+ * remaining gates are applied and the pending measurements are sampled
+ * together; the outcome is applied by collapsing the state vector.
+ *
+ * Reset is a measurement followed by an X gate if the qubit was found in
+ * |1>. Qubits that have not been acted upon since the start of the shot are
+ * known to be in |0>, so resetting them is free.
+ *
+ * If a shot's only measurements come at the end of the program (i.e., there
+ * is a single batch of measurements and no gates follow it), the final state
+ * vector is kept. When later shots build an identical circuit, results are
+ * drawn from that state without re-simulating.
+ *
+ * The state vectors and the gate kernels that act on them are provided by a
+ * \c QsimKernel for the instruction set chosen at run time; this class
+ * only builds, fuses, and compares circuits. The state vector persists
+ * between shots: it is reinitialized in place and only reallocated if the
+ * number of qubits changes.
+ */
+template<class FP>
+class QsimEngineImpl final : public QsimEngine
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using fp_type = FP;
+    using Gate = qsim::GateQSim<fp_type>;
+    using Matrix = std::vector<fp_type>;
+    using Fuser = qsim::MultiQubitGateFuser<qsim::IO, Gate>;
+    using Kernel = QsimKernel<fp_type>;
+    //!@}
+
+  public:
+    // Construct with parameters and an instruction set kernel
+    QsimEngineImpl(Params const& params, std::unique_ptr<Kernel> kernel);
+
+    //!@{
+    //! \name Engine interface
+    void set_up(size_type num_qubits, size_type num_results) final;
+    void tear_down() final;
+    void add_gate(QsimOp const& op) final;
+    void mz(unsigned int qubit, size_type result) final;
+    void reset(unsigned int qubit) final;
+    bool read_result(size_type result) final;
+    size_type num_simulations() const final { return num_simulations_; }
+    char const* isa() const final { return kernel_->isa(); }
+    //!@}
+
+  private:
+    //// CONSTANTS ////
+
+    //! Number of samples drawn from a cached state the first time
+    static constexpr size_type initial_batch_size = 16;
+    //! Maximum number of samples drawn from a cached state at once
+    static constexpr size_type max_batch_size = size_type(1) << 20;
+    //! Number of unapplied gates that triggers fusion and application
+    static constexpr size_type fusion_window = 64;
+    //! Result index of a measurement made by a reset
+    static constexpr size_type no_result = static_cast<size_type>(-1);
+
+    //// TYPES ////
+
+    //! Deferred measurement of a qubit into a result
+    struct Measurement
+    {
+        unsigned int qubit;
+        size_type result;
+
+        bool operator==(Measurement const& other) const
+        {
+            return qubit == other.qubit && result == other.result;
+        }
+    };
+
+    //! Final state of a circuit whose measurements are all terminal
+    struct SampleCache
+    {
+        std::vector<Gate> gates;
+        std::vector<Measurement> measurements;
+        std::vector<std::uint64_t> samples;
+        size_type next_sample{0};
+        size_type batch_size{initial_batch_size};
+        std::mt19937 rng;
+        bool tentative{false};  //!< Created during the current shot
+        bool valid{false};  //!< Confirmed by a completed shot; state saved
+        bool disabled{false};  //!< Program has mid-circuit measurements
+    };
+
+    //! Measurement outcome to be applied to the state
+    struct Outcome
+    {
+        std::uint64_t mask;
+        std::uint64_t bits;
+    };
+
+    //// DATA ////
+
+    Params params_;
+    unsigned long int seed_;
+    std::unique_ptr<Kernel> kernel_;
+    size_type num_qubits_{0};
+    std::vector<bool> results_;
+    // Qubits that may not be in |0>
+    std::uint64_t touched_{0};
+    size_type num_simulations_{0};
+
+    // Gates since the last measurement, the first few of which may have
+    // already been applied to the state
+    qsim::Circuit<Gate> circuit_;
+    size_type num_applied_{0};
+    unsigned int time_{0};
+
+    // State vector has been initialized for the current shot
+    bool initialized_{false};
+
+    // Measurements that have not yet been sampled
+    std::vector<Measurement> pending_;
+    std::uint64_t pending_mask_{0};
+    // Sampled outcome that has not yet been applied to the state
+    std::optional<Outcome> outcome_;
+    // State was not simulated because the outcome came from the cache
+    bool stale_{false};
+    // Number of measurement batches and whether gates followed one
+    size_type num_measure_batches_{0};
+    bool gate_after_measure_{false};
+
+    SampleCache cache_;
+
+    //// HELPER FUNCTIONS ////
+
+    Gate make_gate(QsimOp const& op);
+    static Matrix make_matrix2(QsimGate gate, double theta);
+    void measure_pending();
+    void apply_gates();
+    void collapse();
+    void create_state();
+    std::uint64_t draw_sample();
+    static bool same_gates(std::vector<Gate> const& a,
+                           std::vector<Gate> const& b);
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with parameters.
+ */
+template<class FP>
+QsimEngineImpl<FP>::QsimEngineImpl(Params const& params,
+                                   std::unique_ptr<Kernel> kernel)
+    : params_{params}, seed_{params.seed}, kernel_{std::move(kernel)}
+{
+    QIREE_EXPECT(kernel_);
+    QIREE_EXPECT(params_.num_threads > 0);
+    QIREE_EXPECT(params_.max_fused_size > 0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare for a new shot.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::set_up(size_type num_qubits, size_type num_results)
+{
+    QIREE_EXPECT(num_qubits > 0);
+    QIREE_VALIDATE(num_qubits <= 64,
+                   << "qsim measurements support at most 64 qubits: got "
+                   << num_qubits);
+
+    results_.assign(num_results, false);
+    num_qubits_ = num_qubits;
+    touched_ = 0;
+
+    // The state vector is reused from the previous shot, and is only
+    // reinitialized when the circuit is first simulated
+    initialized_ = false;
+
+    circuit_ = {};
+    circuit_.num_qubits = num_qubits_;
+    num_applied_ = 0;
+    time_ = 0;
+
+    // Reset deferred measurements
+    pending_.clear();
+    pending_mask_ = 0;
+    outcome_.reset();
+    stale_ = false;
+    num_measure_batches_ = 0;
+    gate_after_measure_ = false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete a shot.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::tear_down()
+{
+    bool const terminal = num_measure_batches_ == 1 && !gate_after_measure_;
+    if (cache_.tentative && terminal)
+    {
+        // Keep the final state to sample future shots
+        kernel_->swap();
+        cache_.tentative = false;
+        cache_.valid = true;
+    }
+    else if ((cache_.tentative || cache_.valid)
+             && (num_measure_batches_ > 1 || gate_after_measure_))
+    {
+        // Gates or measurements follow measurements: the program may use
+        // feedback, so the circuit for one shot cannot be reused for the next
+        cache_ = {};
+        cache_.disabled = true;
+        kernel_->release(QsimSlot::cache);
+    }
+    cache_.tentative = false;
+
+    circuit_ = {};
+    num_applied_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add a gate to the circuit.
+ *
+ * Gates acting on a qubit with a pending measurement trigger simulation.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::add_gate(QsimOp const& op)
+{
+    Gate gate = this->make_gate(op);
+    std::uint64_t mask = 0;
+    for (auto q : gate.qubits)
+    {
+        mask |= std::uint64_t(1) << q;
+    }
+    touched_ |= mask;
+    for (auto q : gate.controlled_by)
+    {
+        mask |= std::uint64_t(1) << q;
+    }
+    if (pending_mask_ & mask)
+    {
+        // Operating on a measured qubit
+        this->measure_pending();
+    }
+    if (num_measure_batches_ > 0)
+    {
+        gate_after_measure_ = true;
+    }
+    circuit_.gates.push_back(std::move(gate));
+
+    // Apply gates as soon as the fusion window fills, unless the circuit may
+    // match the cached terminal-measurement state
+    bool const may_use_cache = num_measure_batches_ == 0 && cache_.valid;
+    if (circuit_.gates.size() - num_applied_ >= fusion_window
+        && !may_use_cache)
+    {
+        this->apply_gates();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a result.
+ *
+ * The measurement is deferred until the result is read or the qubit is used
+ * again.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::mz(unsigned int qubit, size_type result)
+{
+    QIREE_EXPECT(qubit < num_qubits_);
+    QIREE_EXPECT(result < results_.size());
+
+    pending_.push_back({qubit, result});
+    pending_mask_ |= std::uint64_t(1) << qubit;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit and flip it back to |0> if needed.
+ *
+ * The measurement is made immediately, together with any pending ones, since
+ * the conditional flip depends on it.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::reset(unsigned int qubit)
+{
+    QIREE_EXPECT(qubit < num_qubits_);
+
+    std::uint64_t const mask = std::uint64_t(1) << qubit;
+    if (!(touched_ & mask))
+    {
+        // No gate has acted on the qubit, so it is still in |0>
+        return;
+    }
+
+    if (!(pending_mask_ & mask))
+    {
+        pending_.push_back({qubit, no_result});
+        pending_mask_ |= mask;
+    }
+    this->measure_pending();
+    QIREE_ASSERT(outcome_);
+    if (outcome_->bits & mask)
+    {
+        this->add_gate({QsimGate::x, {qubit}});
+    }
+    touched_ &= ~mask;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a result.
+ *
+ * This triggers simulation if any measurements are pending.
+ */
+template<class FP>
+bool QsimEngineImpl<FP>::read_result(size_type result)
+{
+    QIREE_EXPECT(result < results_.size());
+    this->measure_pending();
+    return results_[result];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a qsim gate from an operation.
+ */
+template<class FP>
+auto QsimEngineImpl<FP>::make_gate(QsimOp const& op) -> Gate
+{
+    auto const t = time_++;
+    auto const& q = op.qubits;
+    auto const angle = static_cast<fp_type>(op.angle);
+    switch (op.gate)
+    {
+        case QsimGate::ccx: {
+            auto gate = qsim::GateX<fp_type>::Create(t, q[2]);
+            return qsim::MakeControlledGate({q[0], q[1]}, gate);
+        }
+        case QsimGate::cnot:
+            return qsim::GateCNot<fp_type>::Create(t, q[0], q[1]);
+        case QsimGate::cy: {
+            auto gate = qsim::GateY<fp_type>::Create(t, q[1]);
+            return qsim::MakeControlledGate({q[0]}, gate);
+        }
+        case QsimGate::cz:
+            return qsim::GateCZ<fp_type>::Create(t, q[0], q[1]);
+        case QsimGate::h:
+            return qsim::GateHd<fp_type>::Create(t, q[0]);
+        case QsimGate::rx:
+            return qsim::GateRX<fp_type>::Create(t, q[0], angle);
+        case QsimGate::ry:
+            return qsim::GateRY<fp_type>::Create(t, q[0], angle);
+        case QsimGate::rz:
+            return qsim::GateRZ<fp_type>::Create(t, q[0], angle);
+        case QsimGate::rxx:
+        case QsimGate::ryy:
+        case QsimGate::rzz:
+            return qsim::GateMatrix2<fp_type>::Create(
+                t, q[0], q[1], make_matrix2(op.gate, op.angle));
+        case QsimGate::s:
+            return qsim::GateS<fp_type>::Create(t, q[0]);
+        case QsimGate::s_adj:
+            return qsim::GateMatrix1<fp_type>::Create(
+                t, q[0], Matrix{1, 0, 0, 0, 0, 0, 0, -1});
+        case QsimGate::swap:
+            return qsim::GateSwap<fp_type>::Create(t, q[0], q[1]);
+        case QsimGate::t:
+            return qsim::GateT<fp_type>::Create(t, q[0]);
+        case QsimGate::t_adj: {
+            fp_type const c = static_cast<fp_type>(std::sqrt(0.5));
+            return qsim::GateMatrix1<fp_type>::Create(
+                t, q[0], Matrix{1, 0, 0, 0, 0, 0, c, -c});
+        }
+        case QsimGate::x:
+            return qsim::GateX<fp_type>::Create(t, q[0]);
+        case QsimGate::y:
+            return qsim::GateY<fp_type>::Create(t, q[0]);
+        case QsimGate::z:
+            return qsim::GateZ<fp_type>::Create(t, q[0]);
+        default:
+            break;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create the matrix of a two-qubit Pauli rotation.
+ *
+ * The result is exp(-i theta/2 P P) as a row-major array of interleaved
+ * real and imaginary parts. It is symmetric in the two qubits, so it does not
+ * depend on qsim's qubit ordering.
+ */
+template<class FP>
+auto QsimEngineImpl<FP>::make_matrix2(QsimGate gate, double theta) -> Matrix
+{
+    auto const c = static_cast<fp_type>(std::cos(theta / 2));
+    auto const s = static_cast<fp_type>(std::sin(theta / 2));
+
+    Matrix m(2 * 4 * 4, fp_type{0});
+    auto set = [&m](int row, int col, fp_type re, fp_type im) {
+        m[2 * (4 * row + col)] = re;
+        m[2 * (4 * row + col) + 1] = im;
+    };
+
+    switch (gate)
+    {
+        case QsimGate::rxx:
+            // cos * I - i sin * XX
+            for (int i = 0; i < 4; ++i)
+            {
+                set(i, i, c, 0);
+                set(i, 3 - i, 0, -s);
+            }
+            break;
+        case QsimGate::ryy:
+            // cos * I - i sin * YY: YY has -1 on the corners of the
+            // antidiagonal and +1 in the middle
+            for (int i = 0; i < 4; ++i)
+            {
+                set(i, i, c, 0);
+                set(i, 3 - i, 0, (i == 0 || i == 3) ? s : -s);
+            }
+            break;
+        case QsimGate::rzz:
+            // Diagonal: exp(-i theta/2) for even parity, exp(i theta/2) odd
+            for (int i = 0; i < 4; ++i)
+            {
+                set(i, i, c, (i == 0 || i == 3) ? -s : s);
+            }
+            break;
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+    return m;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate the circuit and sample all pending measurements.
+ *
+ * The outcome is stored and only applied to the state vector (collapsing it)
+ * if more gates or measurements follow.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::measure_pending()
+{
+    if (pending_.empty())
+    {
+        return;
+    }
+
+    // Apply the outcome of any previous measurements
+    this->collapse();
+
+    bool const first = (num_measure_batches_++ == 0);
+    if (first && cache_.valid && cache_.measurements == pending_
+        && same_gates(cache_.gates, circuit_.gates))
+    {
+        // Same circuit as a previous terminal-measurement shot
+        stale_ = true;
+    }
+    else
+    {
+        if (first && !cache_.disabled)
+        {
+            // Save the circuit in case all measurements are terminal
+            cache_ = {};
+            kernel_->release(QsimSlot::cache);
+            cache_.gates = circuit_.gates;
+            cache_.measurements = pending_;
+            cache_.rng.seed(seed_++);
+            cache_.tentative = true;
+        }
+
+        // Apply the gates not yet applied
+        this->apply_gates();
+        ++num_simulations_;
+    }
+
+    //// RESET CIRCUIT ////
+
+    circuit_ = {};
+    circuit_.num_qubits = num_qubits_;
+    num_applied_ = 0;
+
+    //// SAMPLE AND STORE RESULTS ////
+
+    // Only the first batch is drawn from the terminal-measurement samples:
+    // later batches measure the state collapsed by earlier outcomes
+    std::uint64_t bits;
+    if (first && (cache_.tentative || stale_))
+    {
+        bits = this->draw_sample();
+    }
+    else
+    {
+        auto samples = kernel_->sample(QsimSlot::state, 1, seed_++);
+        QIREE_ASSERT(samples.size() == 1);
+        bits = samples.front();
+    }
+
+    for (auto const& m : pending_)
+    {
+        if (m.result != no_result)
+        {
+            results_[m.result] = (bits >> m.qubit) & 1;
+        }
+    }
+
+    outcome_ = Outcome{pending_mask_, bits & pending_mask_};
+
+    pending_.clear();
+    pending_mask_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Fuse the unapplied gates and apply them to the state vector.
+ *
+ * The state is first brought up to date by applying any measurement outcome
+ * and, at the start of a shot, initializing it to zero. Applied gates are
+ * kept in the circuit only while they might still be needed to create the
+ * terminal-measurement cache.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::apply_gates()
+{
+    this->collapse();
+    if (!initialized_)
+    {
+        this->create_state();
+        kernel_->set_zero(QsimSlot::state);
+        initialized_ = true;
+    }
+
+    auto const& gates = circuit_.gates;
+    QIREE_ASSERT(num_applied_ <= gates.size());
+    if (num_applied_ < gates.size())
+    {
+        typename Fuser::Parameter param;
+        param.max_fused_size = params_.max_fused_size;
+        param.verbosity = 0;
+
+        auto fused = Fuser::FuseGates(
+            param, num_qubits_, gates.cbegin() + num_applied_, gates.cend());
+        for (auto const& fgate : fused)
+        {
+            // Controlled gates are never fused with others
+            auto const& parent = *fgate.parent;
+            if (parent.controlled_by.empty())
+            {
+                kernel_->apply_gate(fgate.qubits, fgate.matrix.data());
+            }
+            else
+            {
+                kernel_->apply_controlled_gate(fgate.qubits,
+                                               parent.controlled_by,
+                                               parent.cmask,
+                                               fgate.matrix.data());
+            }
+        }
+    }
+
+    if (num_measure_batches_ == 0 && !cache_.disabled)
+    {
+        // Gates may be saved in the cache when the first batch is measured
+        num_applied_ = gates.size();
+    }
+    else
+    {
+        circuit_.gates.clear();
+        num_applied_ = 0;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the outcome of the last measurements to the state vector.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::collapse()
+{
+    if (!outcome_)
+    {
+        return;
+    }
+
+    if (stale_)
+    {
+        // Restore the unmeasured state from the cache
+        this->create_state();
+        kernel_->copy(QsimSlot::cache, QsimSlot::state);
+        initialized_ = true;
+        stale_ = false;
+    }
+    kernel_->collapse(outcome_->mask, outcome_->bits);
+    outcome_.reset();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Allocate the state vector if needed.
+ *
+ * The state vector persists between shots, so it is only reallocated when the
+ * number of qubits changes. Its contents are undefined until initialized by
+ * the caller.
+ */
+template<class FP>
+void QsimEngineImpl<FP>::create_state()
+{
+    kernel_->allocate(QsimSlot::state,
+                      static_cast<unsigned int>(num_qubits_));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Draw the next sample from the terminal-measurement state.
+ *
+ * Samples are generated in batches whose size doubles (up to a limit) each
+ * time the previous batch is used up. Since qsim returns the samples in order
+ * of increasing state index, each batch is shuffled.
+ */
+template<class FP>
+std::uint64_t QsimEngineImpl<FP>::draw_sample()
+{
+    if (cache_.next_sample == cache_.samples.size())
+    {
+        auto source = cache_.valid ? QsimSlot::cache : QsimSlot::state;
+        cache_.samples = kernel_->sample(source, cache_.batch_size, seed_++);
+        QIREE_ASSERT(!cache_.samples.empty());
+        std::shuffle(cache_.samples.begin(), cache_.samples.end(), cache_.rng);
+        cache_.next_sample = 0;
+        cache_.batch_size = std::min(2 * cache_.batch_size, max_batch_size);
+    }
+    return cache_.samples[cache_.next_sample++];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether two sequences of gates are the same operations.
+ */
+template<class FP>
+bool QsimEngineImpl<FP>::same_gates(std::vector<Gate> const& a,
+                                   std::vector<Gate> const& b)
+{
+    auto same = [](Gate const& x, Gate const& y) {
+        return x.kind == y.kind && x.qubits == y.qubits
+               && x.controlled_by == y.controlled_by && x.params == y.params
+               && x.matrix == y.matrix;
+    };
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), same);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
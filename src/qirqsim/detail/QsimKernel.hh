@@ -0,0 +1,122 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimKernel.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+//! State vector owned by a qsim kernel
+enum class QsimSlot
+{
+    state,  //!< State being simulated
+    cache,  //!< Saved final state of a terminal-measurement circuit
+    size_
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * State vectors and the instruction-set-specific qsim operations on them.
+ *
+ * The qsim simulators and state spaces are specialized for a vector
+ * instruction set, and their code must be compiled with the corresponding
+ * flags. Each one is instantiated in its own translation unit behind this
+ * interface, so that the rest of the engine (circuit construction, gate
+ * fusion, and measurement bookkeeping) is compiled for the baseline
+ * architecture and runs on any CPU.
+ */
+template<class FP>
+class QsimKernel
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using fp_type = FP;
+    using VecQubit = std::vector<unsigned int>;
+    using VecSample = std::vector<std::uint64_t>;
+    //!@}
+
+  public:
+    virtual ~QsimKernel() = default;
+
+    // Name of the instruction set
+    virtual char const* isa() const = 0;
+
+    // Allocate a state vector unless one with this many qubits exists
+    virtual void allocate(QsimSlot slot, unsigned int num_qubits) = 0;
+
+    // Free a state vector
+    virtual void release(QsimSlot slot) = 0;
+
+    // Initialize a state vector to |0...0>
+    virtual void set_zero(QsimSlot slot) = 0;
+
+    // Copy one allocated state vector into another of the same size
+    virtual void copy(QsimSlot src, QsimSlot dst) = 0;
+
+    // Exchange the simulated and cached state vectors
+    virtual void swap() = 0;
+
+    // Apply a (fused) gate matrix to the simulated state
+    virtual void apply_gate(VecQubit const& qubits, fp_type const* matrix)
+        = 0;
+
+    // Apply a gate matrix conditional on the values of control qubits
+    virtual void apply_controlled_gate(VecQubit const& qubits,
+                                       VecQubit const& controls,
+                                       std::uint64_t control_values,
+                                       fp_type const* matrix)
+        = 0;
+
+    // Sample measurements of all qubits
+    virtual VecSample
+    sample(QsimSlot slot, std::uint64_t num_samples, unsigned int seed)
+        = 0;
+
+    // Project the simulated state onto a measurement outcome
+    virtual void collapse(std::uint64_t mask, std::uint64_t bits) = 0;
+
+  protected:
+    QsimKernel() = default;
+    QsimKernel(QsimKernel const&) = default;
+    QsimKernel& operator=(QsimKernel const&) = default;
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+// Each returns null if the compiler does not support the instruction set
+
+// Create a single-precision kernel using AVX-512 instructions
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_avx512(unsigned int num_threads);
+
+// Create a single-precision kernel using AVX2 and FMA instructions
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_avx2(unsigned int num_threads);
+
+// Create a single-precision kernel using SSE4.1 instructions
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_sse4(unsigned int num_threads);
+
+// Create a single-precision kernel without vector instructions
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_basic(unsigned int num_threads);
+
+// Create a double-precision kernel without vector instructions
+std::unique_ptr<QsimKernel<double>>
+make_qsim_kernel_basic_double(unsigned int num_threads);
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
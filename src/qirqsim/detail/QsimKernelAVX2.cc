@@ -0,0 +1,43 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimKernelAVX2.cc
+//! \brief Qsim kernel compiled with AVX2 and FMA instructions
+//---------------------------------------------------------------------------//
+#include "QsimKernel.hh"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#    include "QsimKernelImpl.hh"
+
+// Qsim
+#    include <qsim/lib/formux.h>
+#    include <qsim/lib/simulator_avx.h>
+#endif
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Create a single-precision kernel using AVX2 and FMA instructions.
+ *
+ * This returns null unless this file is compiled with AVX2 and FMA enabled.
+ */
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_avx2(unsigned int num_threads)
+{
+#if defined(__AVX2__) && defined(__FMA__)
+    using Simulator = qsim::SimulatorAVX<qsim::For>;
+    return std::make_unique<QsimKernelImpl<Simulator>>("avx2", num_threads);
+#else
+    static_cast<void>(num_threads);
+    return nullptr;
+#endif
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
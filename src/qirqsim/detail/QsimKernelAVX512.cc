@@ -0,0 +1,43 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimKernelAVX512.cc
+//! \brief Qsim kernel compiled with AVX-512 instructions
+//---------------------------------------------------------------------------//
+#include "QsimKernel.hh"
+
+#if defined(__AVX512F__)
+#    include "QsimKernelImpl.hh"
+
+// Qsim
+#    include <qsim/lib/formux.h>
+#    include <qsim/lib/simulator_avx512.h>
+#endif
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Create a single-precision kernel using AVX-512 instructions.
+ *
+ * This returns null unless this file is compiled with AVX-512 enabled.
+ */
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_avx512(unsigned int num_threads)
+{
+#if defined(__AVX512F__)
+    using Simulator = qsim::SimulatorAVX512<qsim::For>;
+    return std::make_unique<QsimKernelImpl<Simulator>>("avx512", num_threads);
+#else
+    static_cast<void>(num_threads);
+    return nullptr;
+#endif
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
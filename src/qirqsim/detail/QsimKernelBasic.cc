@@ -0,0 +1,45 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimKernelBasic.cc
+//! \brief Qsim kernels compiled for the baseline architecture
+//---------------------------------------------------------------------------//
+#include "QsimKernel.hh"
+
+#include "QsimKernelImpl.hh"
+
+// Qsim
+#include <qsim/lib/formux.h>
+#include <qsim/lib/simulator_basic.h>
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Create a single-precision kernel without vector instructions.
+ */
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_basic(unsigned int num_threads)
+{
+    using Simulator = qsim::SimulatorBasic<qsim::For, float>;
+    return std::make_unique<QsimKernelImpl<Simulator>>("basic", num_threads);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a double-precision kernel without vector instructions.
+ */
+std::unique_ptr<QsimKernel<double>>
+make_qsim_kernel_basic_double(unsigned int num_threads)
+{
+    using Simulator = qsim::SimulatorBasic<qsim::For, double>;
+    return std::make_unique<QsimKernelImpl<Simulator>>("basic", num_threads);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,220 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimKernelImpl.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <optional>
+#include <utility>
+
+#include "qiree/Assert.hh"
+
+#include "QsimKernel.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Own state vectors and apply gates with a qsim simulator.
+ *
+ * This must only be instantiated in a translation unit compiled for the
+ * simulator's instruction set: see \c QsimKernelAVX2.cc and friends.
+ */
+template<class S>
+class QsimKernelImpl final
+    : public QsimKernel<typename S::StateSpace::fp_type>
+{
+    using Base = QsimKernel<typename S::StateSpace::fp_type>;
+
+  public:
+    //!@{
+    //! \name Type aliases
+    using Simulator = S;
+    using StateSpace = typename Simulator::StateSpace;
+    using StateVector = typename StateSpace::State;
+    using MeasurementResult = typename StateSpace::MeasurementResult;
+    using typename Base::fp_type;
+    using typename Base::VecQubit;
+    using typename Base::VecSample;
+    //!@}
+
+  public:
+    // Construct with the instruction set name and number of threads
+    QsimKernelImpl(char const* isa, unsigned int num_threads);
+
+    //!@{
+    //! \name Kernel interface
+    char const* isa() const final { return isa_; }
+    void allocate(QsimSlot slot, unsigned int num_qubits) final;
+    void release(QsimSlot slot) final { this->get(slot).reset(); }
+    void set_zero(QsimSlot slot) final;
+    void copy(QsimSlot src, QsimSlot dst) final;
+    void swap() final;
+    void apply_gate(VecQubit const& qubits, fp_type const* matrix) final;
+    void apply_controlled_gate(VecQubit const& qubits,
+                               VecQubit const& controls,
+                               std::uint64_t control_values,
+                               fp_type const* matrix) final;
+    VecSample sample(QsimSlot slot,
+                     std::uint64_t num_samples,
+                     unsigned int seed) final;
+    void collapse(std::uint64_t mask, std::uint64_t bits) final;
+    //!@}
+
+  private:
+    char const* isa_;
+    StateSpace space_;
+    Simulator sim_;
+    std::array<std::optional<StateVector>, std::size_t(QsimSlot::size_)>
+        states_;
+
+    std::optional<StateVector>& get(QsimSlot slot)
+    {
+        QIREE_EXPECT(slot < QsimSlot::size_);
+        return states_[static_cast<std::size_t>(slot)];
+    }
+
+    StateVector& get_allocated(QsimSlot slot)
+    {
+        auto& state = this->get(slot);
+        QIREE_EXPECT(state);
+        return *state;
+    }
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the instruction set name and number of threads.
+ */
+template<class S>
+QsimKernelImpl<S>::QsimKernelImpl(char const* isa, unsigned int num_threads)
+    : isa_{isa}, space_{num_threads}, sim_{num_threads}
+{
+    QIREE_EXPECT(isa_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Allocate a state vector unless one with this many qubits exists.
+ *
+ * The contents of a newly allocated state are undefined.
+ */
+template<class S>
+void QsimKernelImpl<S>::allocate(QsimSlot slot, unsigned int num_qubits)
+{
+    auto& state = this->get(slot);
+    if (state && state->num_qubits() == num_qubits)
+    {
+        return;
+    }
+
+    // Release the old state before allocating the new one
+    state.reset();
+    state = space_.Create(num_qubits);
+    QIREE_VALIDATE(!space_.IsNull(*state),
+                   << "not enough memory: is the number of qubits too large?");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize a state vector to |0...0>.
+ */
+template<class S>
+void QsimKernelImpl<S>::set_zero(QsimSlot slot)
+{
+    space_.SetStateZero(this->get_allocated(slot));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Copy one allocated state vector into another of the same size.
+ */
+template<class S>
+void QsimKernelImpl<S>::copy(QsimSlot src, QsimSlot dst)
+{
+    bool copied
+        = space_.Copy(this->get_allocated(src), this->get_allocated(dst));
+    QIREE_ASSERT(copied);
+    static_cast<void>(copied);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Exchange the simulated and cached state vectors.
+ */
+template<class S>
+void QsimKernelImpl<S>::swap()
+{
+    this->get(QsimSlot::state).swap(this->get(QsimSlot::cache));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a (fused) gate matrix to the simulated state.
+ */
+template<class S>
+void QsimKernelImpl<S>::apply_gate(VecQubit const& qubits,
+                                   fp_type const* matrix)
+{
+    sim_.ApplyGate(qubits, matrix, this->get_allocated(QsimSlot::state));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a gate matrix conditional on the values of control qubits.
+ *
+ * Bit \em i of \c control_values is the value that control qubit \em i
+ * must have for the gate to act.
+ */
+template<class S>
+void QsimKernelImpl<S>::apply_controlled_gate(VecQubit const& qubits,
+                                              VecQubit const& controls,
+                                              std::uint64_t control_values,
+                                              fp_type const* matrix)
+{
+    sim_.ApplyControlledGate(qubits,
+                             controls,
+                             control_values,
+                             matrix,
+                             this->get_allocated(QsimSlot::state));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample measurements of all qubits.
+ *
+ * The samples are returned in order of increasing state index.
+ */
+template<class S>
+auto QsimKernelImpl<S>::sample(QsimSlot slot,
+                               std::uint64_t num_samples,
+                               unsigned int seed) -> VecSample
+{
+    return space_.Sample(this->get_allocated(slot), num_samples, seed);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Project the simulated state onto a measurement outcome.
+ */
+template<class S>
+void QsimKernelImpl<S>::collapse(std::uint64_t mask, std::uint64_t bits)
+{
+    MeasurementResult outcome;
+    outcome.mask = mask;
+    outcome.bits = bits & mask;
+    outcome.valid = true;
+    space_.Collapse(outcome, this->get_allocated(QsimSlot::state));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
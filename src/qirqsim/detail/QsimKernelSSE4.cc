@@ -0,0 +1,43 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirqsim/detail/QsimKernelSSE4.cc
+//! \brief Qsim kernel compiled with SSE4.1 instructions
+//---------------------------------------------------------------------------//
+#include "QsimKernel.hh"
+
+#if defined(__SSE4_1__)
+#    include "QsimKernelImpl.hh"
+
+// Qsim
+#    include <qsim/lib/formux.h>
+#    include <qsim/lib/simulator_sse.h>
+#endif
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Create a single-precision kernel using SSE4.1 instructions.
+ *
+ * This returns null unless this file is compiled with SSE4.1 enabled.
+ */
+std::unique_ptr<QsimKernel<float>>
+make_qsim_kernel_sse4(unsigned int num_threads)
+{
+#if defined(__SSE4_1__)
+    using Simulator = qsim::SimulatorSSE<qsim::For>;
+    return std::make_unique<QsimKernelImpl<Simulator>>("sse4", num_threads);
+#else
+    static_cast<void>(num_threads);
+    return nullptr;
+#endif
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -7,7 +7,11 @@
 //---------------------------------------------------------------------------//
 #include "XaccDefaultRuntime.hh"
 
+#include <iostream>
+#include <string>
+
 #include "qiree/Assert.hh"
+#include "qiree/ResultSink.hh"
 
 namespace qiree
 {
@@ -19,7 +23,9 @@ void XaccDefaultRuntime::initialize(OptionalCString env)
 {
     if (env)
     {
-        output_ << "Argument to initialize: " << env << std::endl;
+        // Keep the output stream free of text when writing records to it
+        (sink_ ? std::clog : output_)
+            << "Argument to initialize: " << env << std::endl;
     }
 }
 
@@ -31,8 +37,11 @@ void XaccDefaultRuntime::initialize(OptionalCString env)
 void XaccDefaultRuntime::array_record_output(size_type s, OptionalCString tag)
 {
     this->execute_if_needed();
-    output_ << "array " << (tag ? tag : "<null>") << " length " << s
-            << std::endl;
+    if (!sink_)
+    {
+        output_ << "array " << (tag ? tag : "<null>") << " length " << s
+                << '\n';
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -43,8 +52,11 @@ void XaccDefaultRuntime::array_record_output(size_type s, OptionalCString tag)
 void XaccDefaultRuntime::tuple_record_output(size_type s, OptionalCString tag)
 {
     this->execute_if_needed();
-    output_ << "tuple " << (tag ? tag : "<null>") << " length " << s
-            << std::endl;
+    if (!sink_)
+    {
+        output_ << "tuple " << (tag ? tag : "<null>") << " length " << s
+                << '\n';
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -59,10 +71,18 @@ void XaccDefaultRuntime::result_record_output(Result r, OptionalCString tag)
     // Get a map of string ("0" and "1" ???) -> int
     auto counts = xacc_.get_marginal_counts({q});
 
+    if (sink_)
+    {
+        std::string const label = tag ? std::string{tag}
+                                      : "qubit " + std::to_string(q.value);
+        sink_->write(label, "0", counts["0"]);
+        sink_->write(label, "1", counts["1"]);
+        return;
+    }
+
     // Print the result
     output_ << "qubit " << q.value << " experiment " << (tag ? tag : "<null>")
-            << ": {0: " << counts["0"] << ", 1: " << counts["1"] << '}'
-            << std::endl;
+            << ": {0: " << counts["0"] << ", 1: " << counts["1"] << "}\n";
 }
 
 //---------------------------------------------------------------------------//
@@ -12,6 +12,7 @@
 
 namespace qiree
 {
+class ResultSink;
 class XaccQuantum;
 
 //---------------------------------------------------------------------------//
@@ -26,6 +27,10 @@ class XaccQuantum;
  * qubit 0 experiment <null>: {0: 509, 1: 515}
  * qubit 1 experiment <null>: {0: 509, 1: 515}
  * \endcode
+ *
+ * If a \c ResultSink is given, each result is instead written to it as two
+ * records (for bits "0" and "1") labeled with the result's tag, or with
+ * "qubit N" if it has none.
  */
 class XaccDefaultRuntime final : virtual public RuntimeInterface
 {
@@ -33,7 +38,8 @@ class XaccDefaultRuntime final : virtual public RuntimeInterface
     // Construct with XACC quantum runtime and options
     inline XaccDefaultRuntime(std::ostream& output,
                               XaccQuantum& xacc,
-                              bool print_accelbuf);
+                              bool print_accelbuf,
+                              ResultSink* sink);
 
     //!@{
     //! \name Runtime interface
@@ -54,6 +60,7 @@ class XaccDefaultRuntime final : virtual public RuntimeInterface
     std::ostream& output_;
     XaccQuantum& xacc_;
     bool const print_accelbuf_;
+    ResultSink* sink_;
 
     void execute_if_needed();
 };
@@ -63,12 +70,19 @@ class XaccDefaultRuntime final : virtual public RuntimeInterface
  * Construct an \c XaccDefaultRuntime.
  *
  * The \c print_accelbuf argument determines whether the XACC \c
- * AcceleratorBuffer is dumped after execution.
+ * AcceleratorBuffer is dumped after execution. Results are written to the
+ * optional \c sink rather than printed, in which case the buffer is never
+ * dumped and diagnostics are written to \c std::clog so that only records
+ * reach the sink's stream.
  */
 XaccDefaultRuntime::XaccDefaultRuntime(std::ostream& output,
                                        XaccQuantum& xacc,
-                                       bool print_accelbuf = true)
-    : output_(output), xacc_(xacc), print_accelbuf_(print_accelbuf)
+                                       bool print_accelbuf = true,
+                                       ResultSink* sink = nullptr)
+    : output_(output)
+    , xacc_(xacc)
+    , print_accelbuf_(print_accelbuf && !sink)
+    , sink_(sink)
 {
 }
 
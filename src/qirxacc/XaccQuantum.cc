@@ -8,18 +8,41 @@
 #include "XaccQuantum.hh"
 
 #include <algorithm>
+#include <cctype>
+#include <fstream>
 #include <iostream>
+#include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <utility>
 #include <xacc/xacc.hpp>
 #include <xacc/xacc_service.hpp>
 
 #include "qiree/Assert.hh"
+#include "qiree/AtomicWrite.hh"
 
 using xacc::constants::pi;
 
 namespace qiree
 {
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Version of the cached circuit format, to be increased when it changes
+constexpr int cache_version = 1;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the path of a cached circuit.
+ */
+std::string cache_path(std::string const& dir, std::string const& key)
+{
+    return dir + '/' + key + ".xasm";
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
 //---------------------------------------------------------------------------//
 /*!
  * Call initialize explicitly with args.
@@ -36,8 +59,20 @@ void XaccQuantum::xacc_init(std::vector<std::string> args)
 XaccQuantum::XaccQuantum(std::ostream& os,
                          std::string const& accel_name,
                          size_type shots)
-    : output_{os}
+    : XaccQuantum{os, accel_name, Options{shots}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with accelerator name and options.
+ */
+XaccQuantum::XaccQuantum(std::ostream& os,
+                         std::string const& accel_name,
+                         Options const& options)
+    : options_{options}, output_{os}, rng_(options.seed)
 {
+    auto const shots = options_.shots;
     QIREE_VALIDATE(shots > 0, << "invalid number of shots " << shots);
 
     if (!xacc::isInitialized())
@@ -60,6 +95,39 @@ XaccQuantum::XaccQuantum(std::ostream& os,
 
     // Create providers
     provider_ = xacc::getIRProvider("quantum");
+    if (options_.native_gates)
+    {
+        capabilities_ = this->query_capabilities(accel_name);
+    }
+
+    // Create an instruction for each gate to be cloned into circuits
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Gate::size_); ++i)
+    {
+        auto gate = static_cast<Gate>(i);
+        if ((gate == Gate::ccx && !capabilities_.ccx)
+            || (gate == Gate::swap && !capabilities_.swap))
+        {
+            // Decomposed into other gates
+            continue;
+        }
+        std::vector<std::size_t> bits(num_gate_qubits(gate));
+        std::iota(bits.begin(), bits.end(), std::size_t{0});
+        std::vector<xacc::InstructionParameter> params;
+        if (gate == Gate::measure)
+        {
+            params.emplace_back(0);
+        }
+        else if (gate == Gate::rx || gate == Gate::ry || gate == Gate::rz
+                 || gate == Gate::rzz)
+        {
+            params.emplace_back(0.0);
+        }
+        prototypes_[i] = provider_->createInstruction(
+            to_xacc_name(gate), std::move(bits), std::move(params));
+        QIREE_VALIDATE(prototypes_[i],
+                       << "failed to create XACC instruction '"
+                       << to_xacc_name(gate) << "'");
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -89,9 +157,28 @@ void XaccQuantum::set_up(EntryPointAttrs const& attrs)
 
     executed_ = false;
     buffer_ = xacc::qalloc(attrs.required_num_qubits);
-    cur_circuit_ = provider_->createComposite("quantum_circuit");
+
+    // Replay the circuit if this program has been built before: circuits
+    // that depend on measured results are never cached
+    cache_key_.clear();
+    from_cache_ = false;
+    if (!options_.dynamic && !attrs.module_hash.empty())
+    {
+        cache_key_ = this->cache_key(attrs);
+        cur_circuit_ = this->load_circuit(cache_key_);
+        from_cache_ = static_cast<bool>(cur_circuit_);
+    }
+    if (!from_cache_)
+    {
+        cur_circuit_ = provider_->createComposite("quantum_circuit");
+    }
+    ops_.clear();
+    ops_hash_ = hash_basis;
+    num_flushed_ = 0;
     result_to_qubit_.resize(attrs.required_num_results);
     num_qubits_ = attrs.required_num_qubits;
+    measured_.assign(attrs.required_num_results, false);
+    sampled_.assign(attrs.required_num_results, std::nullopt);
 }
 
 //---------------------------------------------------------------------------//
@@ -100,6 +187,11 @@ void XaccQuantum::set_up(EntryPointAttrs const& attrs)
  */
 void XaccQuantum::tear_down()
 {
+    if (!cache_key_.empty() && !from_cache_)
+    {
+        this->flush_ops();
+        this->store_circuit(cache_key_);
+    }
     cur_circuit_.reset();
     buffer_.reset();
 }
@@ -114,14 +206,19 @@ void XaccQuantum::mz(Qubit q, Result r)
     QIREE_EXPECT(r.value < this->num_results());
 
     result_to_qubit_[r.value] = q;
-    this->add_instruction("Measure", {q}, static_cast<int>(r.value));
+    this->add_op(Gate::measure, {q}, static_cast<double>(r.value));
+    measured_[r.value] = true;
+    sampled_[r.value].reset();
 }
 
 //---------------------------------------------------------------------------//
 /*!
  * Read the value of a result.
  *
- * NOTE: this is currently used *only* for the feed-forward operation in
+ * In dynamic mode, this samples the circuit built so far. Otherwise the
+ * circuit has not been executed and this always returns |1>.
+ *
+ * NOTE: in batch mode this is used *only* for the feed-forward operation in
  * \c teleport.ll corresponding to the following instructions emitted from
  * \code
 qis.if_result(results[0], one=lambda: qis.z(target))
@@ -147,6 +244,10 @@ QState XaccQuantum::read_result(Result r) const
 {
     QIREE_EXPECT(r.value < this->num_results());
 
+    if (options_.dynamic)
+    {
+        return this->sample_result(r);
+    }
     return QState::one;
 }
 
@@ -155,53 +256,51 @@ QState XaccQuantum::read_result(Result r) const
 //---------------------------------------------------------------------------//
 void XaccQuantum::ccx(Qubit q1, Qubit q2, Qubit q3)
 {
-    // XACC IR does not have a Toffoli gate
-    this->add_ctrl_list_instruction("X", {q1, q2}, q3);
+    this->add_op(Gate::ccx, {q1, q2, q3});
 }
 void XaccQuantum::ccnot(Qubit q1, Qubit q2, Qubit q3)
 {
-    // XACC IR does not have a Toffoli gate
-    this->add_ctrl_list_instruction("X", {q1, q2}, q3);
+    this->add_op(Gate::ccx, {q1, q2, q3});
 }
 void XaccQuantum::cnot(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CNOT", {q1, q2});
+    this->add_op(Gate::cnot, {q1, q2});
 }
 void XaccQuantum::cx(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CX", {q1, q2});
+    this->add_op(Gate::cx, {q1, q2});
 }
 void XaccQuantum::cy(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CY", {q1, q2});
+    this->add_op(Gate::cy, {q1, q2});
 }
 void XaccQuantum::cz(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CZ", {q1, q2});
+    this->add_op(Gate::cz, {q1, q2});
 }
 void XaccQuantum::h(Qubit q)
 {
-    this->add_instruction("H", q);
+    this->add_op(Gate::h, {q});
 }
 void XaccQuantum::reset(Qubit q)
 {
-    this->add_instruction("Reset", q);
+    this->add_op(Gate::reset, {q});
 }
 void XaccQuantum::rx(double angle, Qubit q)
 {
-    this->add_instruction("Rx", q, angle);
+    this->add_op(Gate::rx, {q}, angle);
 }
 void XaccQuantum::ry(double angle, Qubit q)
 {
-    this->add_instruction("Ry", q, angle);
+    this->add_op(Gate::ry, {q}, angle);
 }
 void XaccQuantum::rz(double angle, Qubit q)
 {
-    this->add_instruction("Rz", q, angle);
+    this->add_op(Gate::rz, {q}, angle);
 }
 void XaccQuantum::rzz(double angle, Qubit q1, Qubit q2)
 {
-    this->add_instruction("RZZ", {q1, q2}, angle);
+    this->add_op(Gate::rzz, {q1, q2}, angle);
 }
 void XaccQuantum::s(Qubit q)
 {
@@ -213,8 +312,11 @@ void XaccQuantum::s_adj(Qubit q)
 }
 void XaccQuantum::swap(Qubit q1, Qubit q2)
 {
+    if (capabilities_.swap)
+    {
+        return this->add_op(Gate::swap, {q1, q2});
+    }
     // compile swap operation into cnots
-    // Dan: we should check if backend can directly implement SWAP first
     this->cnot(q1, q2);
     this->cnot(q2, q1);
     this->cnot(q1, q2);
@@ -229,15 +331,15 @@ void XaccQuantum::t_adj(Qubit q)
 }
 void XaccQuantum::x(Qubit q)
 {
-    this->add_instruction("X", q);
+    this->add_op(Gate::x, {q});
 }
 void XaccQuantum::y(Qubit q)
 {
-    this->add_instruction("Y", q);
+    this->add_op(Gate::y, {q});
 }
 void XaccQuantum::z(Qubit q)
 {
-    this->add_instruction("Z", q);
+    this->add_op(Gate::z, {q});
 }
 
 //---------------------------------------------------------------------------//
@@ -288,6 +390,7 @@ bool XaccQuantum::execute_if_needed()
 
     try
     {
+        this->flush_ops();
         accelerator_->execute(buffer_, cur_circuit_);
         executed_ = true;
     }
@@ -311,99 +414,433 @@ void XaccQuantum::print_accelbuf()
 // PRIVATE FUNCTIONS
 //---------------------------------------------------------------------------//
 /*!
- * Add an instruction with a single qubit.
+ * Sample the results measured by the current prefix.
+ *
+ * All results measured so far are sampled together, so reading the others
+ * afterward does not require another execution. The sample is the first
+ * unused one from this prefix that agrees with the results already read in
+ * this shot; more are drawn from the accelerator if none does.
+ *
+ * Prefixes are identified by their number of gates and a running hash of
+ * them, so looking up the samples does not depend on the circuit length. At
+ * most \c max_prefixes prefixes keep their unused samples: when a new one
+ * would exceed that, all are discarded.
+ */
+QState XaccQuantum::sample_result(Result r) const
+{
+    if (auto const& value = sampled_[r.value])
+    {
+        return *value;
+    }
+    QIREE_VALIDATE(measured_[r.value],
+                   << "result " << r.value << " was read before it was "
+                   << "measured");
+
+    // Results measured in the prefix and the qubits that hold them
+    std::vector<size_type> results;
+    std::vector<int> qubits;
+    for (size_type i = 0; i < measured_.size(); ++i)
+    {
+        if (measured_[i])
+        {
+            results.push_back(i);
+            qubits.push_back(static_cast<int>(result_to_qubit_[i].value));
+        }
+    }
+
+    auto agrees = [this, &results](std::string const& bits) {
+        QIREE_ASSERT(bits.size() == results.size());
+        for (size_type i = 0; i < results.size(); ++i)
+        {
+            auto const& value = sampled_[results[i]];
+            if (value && (*value == QState::one) != (bits[i] == '1'))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Find (or draw) a sample consistent with the branches taken
+    constexpr int max_executions = 16;
+    auto const key = this->prefix_key();
+    if (prefix_samples_.size() >= max_prefixes
+        && prefix_samples_.find(key) == prefix_samples_.end())
+    {
+        // Bound the memory used by programs with many distinct branches
+        prefix_samples_.clear();
+    }
+    VecSample& samples = prefix_samples_[key];
+    auto iter = std::find_if(samples.begin(), samples.end(), agrees);
+    for (int i = 0; iter == samples.end(); ++i)
+    {
+        QIREE_VALIDATE(i < max_executions,
+                       << "no sample of the circuit agrees with the results "
+                          "read earlier in this shot after "
+                       << i * options_.shots << " shots");
+        auto const start = samples.size();
+        this->execute_prefix(qubits, &samples);
+        iter = std::find_if(samples.begin() + start, samples.end(), agrees);
+    }
+
+    std::string bits = std::move(*iter);
+    *iter = std::move(samples.back());
+    samples.pop_back();
+
+    for (size_type i = 0; i < results.size(); ++i)
+    {
+        sampled_[results[i]] = bits[i] == '1' ? QState::one : QState::zero;
+    }
+    return *sampled_[r.value];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute the current prefix and append its samples in random order.
+ */
+void XaccQuantum::execute_prefix(std::vector<int> const& qubits,
+                                 VecSample* samples) const
+{
+    using BitOrder = xacc::AcceleratorBuffer::BitOrder;
+    QIREE_EXPECT(samples);
+
+    this->flush_ops();
+    auto buffer = xacc::qalloc(num_qubits_);
+    accelerator_->execute(buffer, cur_circuit_);
+    ++num_executions_;
+
+    auto const counts = buffer->getMarginalCounts(
+        qubits, endian_ == Endianness::little ? BitOrder::LSB : BitOrder::MSB);
+    auto const start = samples->size();
+    for (auto const& [bits, count] : counts)
+    {
+        samples->insert(samples->end(), count, bits);
+    }
+    std::shuffle(samples->begin() + start, samples->end(), rng_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the cache key of the circuit built by an entry point.
+ *
+ * The key is also the base name of the cached file, so characters other than
+ * alphanumerics, dots, and underscores in the entry point and accelerator
+ * names are replaced. Since SWAP and Toffoli gates are decomposed unless the
+ * accelerator supports them natively (and native gates are enabled), the
+ * gates used are part of the key, as is the version of the cache format.
+ */
+std::string XaccQuantum::cache_key(EntryPointAttrs const& attrs) const
+{
+    auto sanitized = [](std::string s) {
+        for (char& c : s)
+        {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.'
+                && c != '_')
+            {
+                c = '_';
+            }
+        }
+        return s;
+    };
+
+    std::string gates = "g";
+    gates += (capabilities_.swap ? '1' : '0');
+    gates += (capabilities_.ccx ? '1' : '0');
+
+    return attrs.module_hash + '-' + sanitized(attrs.entry_point) + '-'
+           + sanitized(accelerator_->name()) + '-' + gates + "-v"
+           + std::to_string(cache_version);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Find a cached circuit in memory or on disk.
+ *
+ * A null pointer is returned if the circuit is not cached or the cached
+ * source cannot be compiled, in which case the circuit is rebuilt.
  */
-template<class... Ts>
-void XaccQuantum::add_instruction(std::string s, Qubit q, Ts... args)
+std::shared_ptr<xacc::CompositeInstruction>
+XaccQuantum::load_circuit(std::string const& key)
 {
-    return this->add_instruction(std::move(s), {q}, std::forward<Ts>(args)...);
+    auto iter = circuit_cache_.find(key);
+    if (iter != circuit_cache_.end())
+    {
+        return iter->second;
+    }
+    if (options_.cache_dir.empty())
+    {
+        return nullptr;
+    }
+
+    std::ifstream infile(cache_path(options_.cache_dir, key));
+    if (!infile)
+    {
+        return nullptr;
+    }
+    std::ostringstream src;
+    src << infile.rdbuf();
+
+    std::shared_ptr<xacc::CompositeInstruction> circuit;
+    try
+    {
+        auto ir = xacc::getCompiler("xasm")->compile(src.str(), accelerator_);
+        auto composites = ir->getComposites();
+        if (!composites.empty())
+        {
+            circuit = std::move(composites.front());
+        }
+    }
+    catch (std::exception const& e)
+    {
+        output_ << "Failed to load cached XACC circuit: " << e.what()
+                << std::endl;
+    }
+    if (circuit)
+    {
+        circuit_cache_.emplace(key, circuit);
+    }
+    return circuit;
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Add an instruction with multiple qubits.
+ * Save the current circuit to the cache.
+ *
+ * The XASM source is written to a uniquely named temporary file that is then
+ * renamed, so that a concurrent process never reads a partially written
+ * circuit or shares a temporary file with this one.
  */
-template<class... Ts>
-void XaccQuantum::add_instruction(std::string s,
-                                  std::initializer_list<Qubit> qs,
-                                  Ts... args)
+void XaccQuantum::store_circuit(std::string const& key)
 {
-    this->add_instruction_to(
-        cur_circuit_, std::move(s), qs, std::forward<Ts>(args)...);
+    QIREE_EXPECT(cur_circuit_);
+    circuit_cache_[key] = cur_circuit_;
+    if (options_.cache_dir.empty())
+    {
+        return;
+    }
+
+    std::string src;
+    try
+    {
+        src = xacc::getCompiler("xasm")->translate(cur_circuit_);
+    }
+    catch (std::exception const& e)
+    {
+        output_ << "Failed to save XACC circuit: " << e.what() << std::endl;
+        return;
+    }
+
+    std::string const path = cache_path(options_.cache_dir, key);
+    if (auto ec = write_atomic(path, src))
+    {
+        output_ << "Failed to write XACC circuit to " << path << ": "
+                << ec.message() << std::endl;
+    }
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Add an instruction with multiple qubits to a particular XACC
- * CompositeInstruction.
+ * Record a gate in the current circuit.
  */
-template<class... Ts>
-void XaccQuantum::add_instruction_to(
-    std::shared_ptr<xacc::CompositeInstruction> circuit,
-    std::string s,
-    std::initializer_list<Qubit> qs,
-    Ts... args)
-{
-    // Transform opaque qubit types into raw integer indices
-    std::vector<std::size_t> q_indices(qs.size());
-    std::transform(qs.begin(), qs.end(), q_indices.begin(), [this](Qubit q) {
+void XaccQuantum::add_op(Gate gate,
+                         std::initializer_list<Qubit> qs,
+                         double param)
+{
+    if (from_cache_)
+    {
+        // The cached circuit already contains this instruction
+        return;
+    }
+    QIREE_EXPECT(qs.size() == num_gate_qubits(gate));
+
+    Op op;
+    op.gate = gate;
+    std::transform(qs.begin(), qs.end(), op.qubits.begin(), [this](Qubit q) {
         QIREE_EXPECT(q.value < this->num_qubits());
-        return q.value;
+        return static_cast<unsigned int>(q.value);
     });
+    op.param = param;
+    ops_.push_back(op);
+
+    // Update the hash of the gates so far
+    auto hash = [this](auto const& value) {
+        auto const* bytes = reinterpret_cast<unsigned char const*>(&value);
+        for (std::size_t i = 0; i < sizeof(value); ++i)
+        {
+            ops_hash_ = (ops_hash_ ^ bytes[i]) * hash_prime;
+        }
+    };
+    hash(op.gate);
+    hash(op.qubits);
+    hash(op.param);
+}
 
-    // Create the instruction
-    using VecInstr = std::vector<xacc::InstructionParameter>;
-    auto instr = provider_->createInstruction(
-        std::move(s), q_indices, VecInstr{std::forward<Ts>(args)...});
+//---------------------------------------------------------------------------//
+/*!
+ * Add XACC instructions for the recorded gates to the current circuit.
+ *
+ * Gates recorded since the last call are cloned from the prototype
+ * instructions and added together.
+ */
+void XaccQuantum::flush_ops() const
+{
+    if (num_flushed_ == ops_.size())
+    {
+        return;
+    }
 
-    // Add to current quantum circuit
-    circuit->addInstruction(std::move(instr));
+    VecInstruction instructions;
+    instructions.reserve(ops_.size() - num_flushed_);
+    for (std::size_t i = num_flushed_; i < ops_.size(); ++i)
+    {
+        Op const& op = ops_[i];
+        if (op.gate == Gate::ccx && !capabilities_.ccx)
+        {
+            this->append_ccx(op, &instructions);
+            continue;
+        }
+
+        auto const& prototype = prototypes_[static_cast<std::size_t>(op.gate)];
+        QIREE_ASSERT(prototype);
+        SPInstruction inst = prototype->clone();
+        inst->setBits(std::vector<std::size_t>(
+            op.qubits.begin(), op.qubits.begin() + num_gate_qubits(op.gate)));
+        if (op.gate == Gate::measure)
+        {
+            xacc::InstructionParameter result{static_cast<int>(op.param)};
+            inst->setParameter(0, result);
+        }
+        else if (!prototype->getParameters().empty())
+        {
+            xacc::InstructionParameter angle{op.param};
+            inst->setParameter(0, angle);
+        }
+        instructions.push_back(std::move(inst));
+    }
+    cur_circuit_->addInstructions(instructions);
+    num_flushed_ = ops_.size();
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Add an instruction with the control indices provided.
+ * Add the decomposition of a Toffoli gate.
+ *
+ * This expands a doubly controlled X gate for accelerators that cannot apply
+ * a Toffoli gate directly.
  */
-template<class... Ts>
-void XaccQuantum::add_ctrl_indices_instruction(std::string s,
-                                               std::vector<int> ctrl_indices,
-                                               Qubit q,
-                                               Ts... args)
+void XaccQuantum::append_ccx(Op const& op, VecInstruction* instructions) const
 {
-    std::shared_ptr<xacc::CompositeInstruction> tmp
-        = provider_->createComposite("tmp");
-    this->add_instruction_to(tmp, std::move(s), {q}, std::forward<Ts>(args)...);
+    QIREE_EXPECT(op.gate == Gate::ccx);
+    QIREE_EXPECT(instructions);
 
-    std::shared_ptr<xacc::CompositeInstruction> cu
-        = std::static_pointer_cast<xacc::CompositeInstruction>(
-            xacc::getService<xacc::Instruction>("C-U"));
-    cu->expand({{"U", tmp}, {"control-idx", ctrl_indices}});
+    auto const& x = prototypes_[static_cast<std::size_t>(Gate::x)];
+    SPInstruction target = x->clone();
+    target->setBits({op.qubits[2]});
+    auto u = provider_->createComposite("tmp");
+    u->addInstruction(std::move(target));
+
+    auto cu = std::static_pointer_cast<xacc::CompositeInstruction>(
+        xacc::getService<xacc::Instruction>("C-U"));
+    std::vector<int> ctrl_indices{static_cast<int>(op.qubits[0]),
+                                  static_cast<int>(op.qubits[1])};
+    cu->expand({{"U", u}, {"control-idx", ctrl_indices}});
 
     for (int i = 0; i < cu->nInstructions(); i++)
     {
-        cur_circuit_->addInstruction(cu->getInstruction(i));
+        instructions->push_back(cu->getInstruction(i));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Determine the gates supported by the accelerator.
+ *
+ * XACC accelerators do not report which instructions they apply directly, so
+ * the accelerator's name (ignoring options such as "aer:statevector") is
+ * looked up in the table of native gates from the options. Unlisted
+ * accelerators, including hardware backends, are assumed to require
+ * decomposition. A Toffoli gate is also used only if the IR provider can
+ * create the instruction.
+ */
+auto XaccQuantum::query_capabilities(std::string const& accel_name) const
+    -> Capabilities
+{
+    auto const& table = options_.native_capabilities;
+    auto iter = table.find(accel_name.substr(0, accel_name.find(':')));
+    if (iter == table.end())
+    {
+        return {};
+    }
+    Capabilities result = iter->second;
+
+    if (result.ccx)
+    {
+        try
+        {
+            result.ccx = static_cast<bool>(provider_->createInstruction(
+                to_xacc_name(Gate::ccx), {0, 1, 2}));
+        }
+        catch (std::exception const&)
+        {
+            // No such instruction in the IR
+            result.ccx = false;
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the XACC name of a gate.
+ */
+char const* XaccQuantum::to_xacc_name(Gate gate)
+{
+    switch (gate)
+    {
+        // clang-format off
+        case Gate::ccx: return "CCX";
+        case Gate::cnot: return "CNOT";
+        case Gate::cx: return "CX";
+        case Gate::cy: return "CY";
+        case Gate::cz: return "CZ";
+        case Gate::h: return "H";
+        case Gate::measure: return "Measure";
+        case Gate::reset: return "Reset";
+        case Gate::rx: return "Rx";
+        case Gate::ry: return "Ry";
+        case Gate::rz: return "Rz";
+        case Gate::rzz: return "RZZ";
+        case Gate::swap: return "Swap";
+        case Gate::x: return "X";
+        case Gate::y: return "Y";
+        case Gate::z: return "Z";
+        // clang-format on
+        default:
+            break;
     }
+    QIREE_ASSERT_UNREACHABLE();
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Add an instruction with the control indices provided as a list of QIR
- * pointers (for convenience).
+ * Get the number of qubits a gate acts on.
  */
-template<class... Ts>
-void XaccQuantum::add_ctrl_list_instruction(
-    std::string s, std::initializer_list<Qubit> ctrl_list, Qubit q, Ts... args)
-{
-    std::vector<int> ctrl_indices(ctrl_list.size());
-    std::transform(ctrl_list.begin(),
-                   ctrl_list.end(),
-                   ctrl_indices.begin(),
-                   [this](Qubit q) {
-                       QIREE_EXPECT(q.value < this->num_qubits());
-                       return static_cast<int>(q.value);
-                   });
-    add_ctrl_indices_instruction(
-        std::move(s), ctrl_indices, q, std::forward<Ts>(args)...);
+std::size_t XaccQuantum::num_gate_qubits(Gate gate)
+{
+    switch (gate)
+    {
+        case Gate::ccx:
+            return 3;
+        case Gate::cnot:
+        case Gate::cx:
+        case Gate::cy:
+        case Gate::cz:
+        case Gate::rzz:
+        case Gate::swap:
+            return 2;
+        default:
+            return 1;
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -7,10 +7,17 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <initializer_list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <ostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "qiree/Macros.hh"
@@ -23,6 +30,7 @@ namespace xacc
 class AcceleratorBuffer;
 class Accelerator;
 class IRProvider;
+class Instruction;
 class CompositeInstruction;
 }  // namespace xacc
 
@@ -32,9 +40,75 @@ namespace qiree
 //---------------------------------------------------------------------------//
 /*!
  * Translate instructions from QIR to XACC and execute them on read.
+ *
+ * By default the whole program is built into a single circuit that is
+ * executed once with the requested number of shots, and the runtime reports
+ * the measurement statistics. Programs that branch on measured results
+ * cannot be run that way, since each shot may build a different circuit.
+ *
+ * In \em dynamic mode, each execution of the program is a single shot, and
+ * reading a result executes the circuit built so far (the "prefix") to sample
+ * every result measured in it. Results sampled earlier in the shot are still
+ * measured by the prefix, so only samples that agree with them are used:
+ * this draws the new results from their distribution conditioned on the
+ * branches already taken. Each execution of a prefix draws \c shots samples,
+ * which are kept and used by later shots that build the same prefix, so a
+ * program whose shots take a few distinct paths costs a few executions per
+ * \c shots shots.
+ *
+ * Results are identified by the qubit they measure: if a qubit is measured
+ * into several results in the same prefix, they all read its last value.
+ *
+ * Gates are recorded in a compact list as the program runs, and XACC
+ * instructions are created from them in bulk only when the circuit is
+ * executed. Each instruction is cloned from a prototype of its gate rather
+ * than looked up by name in the XACC service registry.
+ *
+ * The multi-qubit gates that an accelerator applies directly are looked up
+ * by its name in \c Options::native_capabilities when it is created; by
+ * default only the XACC simulators are listed. SWAP and Toffoli gates are
+ * decomposed into CNOT and controlled gates unless the accelerator supports
+ * them.
+ *
+ * In batch mode, the finished circuit is cached under the hash of the module
+ * that built it, its entry point, and the accelerator. Executing the same
+ * program again replays the cached circuit rather than creating and
+ * decomposing each instruction. The cache is kept in memory and, if a
+ * \c cache_dir is given, written to disk as XASM source so that later
+ * processes reuse it.
  */
 class XaccQuantum final : virtual public QuantumNotImpl
 {
+  public:
+    //! Gates the accelerator applies without decomposition
+    struct Capabilities
+    {
+        bool swap{false};  //!< Two-qubit SWAP
+        bool ccx{false};  //!< Toffoli (doubly controlled X)
+    };
+
+    //! Execution options
+    struct Options
+    {
+        //! Number of shots per accelerator execution
+        size_type shots{1024};
+        //! Execute one shot at a time, branching on read results
+        bool dynamic{false};
+        //! Random seed for drawing samples in dynamic mode
+        unsigned long int seed{0};
+        //! Directory of cached circuits (empty to cache only in memory)
+        std::string cache_dir;
+        //! Use multi-qubit gates that the accelerator supports natively
+        bool native_gates{true};
+        //! Native gates of each accelerator, by name without options
+        std::map<std::string, Capabilities> native_capabilities{
+            {"aer", {true, true}},
+            {"qpp", {true, true}},
+            {"qsim", {true, true}},
+            {"quest", {true, true}},
+        };
+    };
+
   public:
     // Call XACC initialize explicitly with args
     static void xacc_init(std::vector<std::string> args);
@@ -44,6 +118,11 @@ class XaccQuantum final : virtual public QuantumNotImpl
                 std::string const& accel_name,
                 size_type shots);
 
+    // Construct with accelerator name and options
+    XaccQuantum(std::ostream& os,
+                std::string const& accel_name,
+                Options const& options);
+
     // Construct with simulator
     explicit XaccQuantum(std::ostream& os);
 
@@ -56,6 +135,12 @@ class XaccQuantum final : virtual public QuantumNotImpl
     //! \name Accessors
     size_type num_results() const { return result_to_qubit_.size(); }
     size_type num_qubits() const { return num_qubits_; }
+    Options const& options() const { return options_; }
+    Capabilities const& capabilities() const { return capabilities_; }
+    //! Number of accelerator executions in dynamic mode
+    size_type num_executions() const { return num_executions_; }
+    //! Whether the current circuit was loaded from the cache
+    bool from_cache() const { return from_cache_; }
     //!@}
 
     //!@{
@@ -122,8 +207,59 @@ class XaccQuantum final : virtual public QuantumNotImpl
         big
     };
 
+    //! Samples drawn from a circuit prefix, in random order
+    using VecSample = std::vector<std::string>;
+
+    //! Gates recorded by the circuit
+    enum class Gate : std::uint8_t
+    {
+        ccx,
+        cnot,
+        cx,
+        cy,
+        cz,
+        h,
+        measure,
+        reset,
+        rx,
+        ry,
+        rz,
+        rzz,
+        swap,
+        x,
+        y,
+        z,
+        size_
+    };
+
+    //! Gate applied to up to three qubits
+    struct Op
+    {
+        Gate gate{Gate::size_};
+        std::array<unsigned int, 3> qubits{};
+        double param{};  //!< Rotation angle or measured result index
+    };
+
+    using SPInstruction = std::shared_ptr<xacc::Instruction>;
+    using VecInstruction = std::vector<SPInstruction>;
+
+    //! Number of gates in a circuit prefix and a hash of them
+    using PrefixKey = std::pair<std::size_t, std::uint64_t>;
+
+    //// CONSTANTS ////
+
+    //! Maximum number of circuit prefixes whose samples are kept
+    static constexpr std::size_t max_prefixes = 1024;
+    //!@{
+    //! 64-bit FNV-1a parameters for hashing the gates
+    static constexpr std::uint64_t hash_basis = 0xcbf29ce484222325ull;
+    static constexpr std::uint64_t hash_prime = 0x100000001b3ull;
+    //!@}
+
     //// DATA ////
 
+    Options options_;
+    Capabilities capabilities_;
     bool executed_{false};
     size_type num_qubits_{};
     std::vector<Qubit> result_to_qubit_;
@@ -135,39 +271,67 @@ class XaccQuantum final : virtual public QuantumNotImpl
     std::shared_ptr<xacc::IRProvider> provider_;
     std::shared_ptr<xacc::CompositeInstruction> cur_circuit_;
 
+    // Gates of the current circuit and a running hash of them, the number
+    // already added to it as XACC instructions, and the instruction cloned
+    // for each gate
+    std::vector<Op> ops_;
+    std::uint64_t ops_hash_{hash_basis};
+    mutable std::size_t num_flushed_{0};
+    std::array<SPInstruction, static_cast<std::size_t>(Gate::size_)>
+        prototypes_;
+
+    // Dynamic mode: results measured in the current shot, their sampled
+    // values, and unused samples for each circuit prefix
+    std::vector<bool> measured_;
+    mutable std::vector<std::optional<QState>> sampled_;
+    mutable std::map<PrefixKey, VecSample> prefix_samples_;
+    mutable std::mt19937 rng_;
+    mutable size_type num_executions_{0};
+
+    // Batch mode: finished circuits, the key of the current one, and whether
+    // it was loaded rather than built
+    std::unordered_map<std::string, std::shared_ptr<xacc::CompositeInstruction>>
+        circuit_cache_;
+    std::string cache_key_;
+    bool from_cache_{false};
+
     //// HELPER FUNCTIONS ////
 
-    // Add an instruction with a single qubit
-    template<class... Ts>
-    void add_instruction(std::string s, Qubit q, Ts... args);
-
-    // Add an instruction with multiple qubits
-    template<class... Ts>
-    void
-    add_instruction(std::string s, std::initializer_list<Qubit> qs, Ts... args);
-
-    // Add an instruction with multiple qubits to a particular XACC
-    // CompositeInstruction
-    template<class... Ts>
-    void add_instruction_to(std::shared_ptr<xacc::CompositeInstruction> circuit,
-                            std::string s,
-                            std::initializer_list<Qubit> qs,
-                            Ts... args);
-
-    // Add an instruction with the control indices provided
-    template<class... Ts>
-    void add_ctrl_indices_instruction(std::string s,
-                                      std::vector<int> ctrl_indices,
-                                      Qubit q,
-                                      Ts... args);
-
-    // Add an instruction with the control indices provided as a list of QIR
-    // pointers (for convenience)
-    template<class... Ts>
-    void add_ctrl_list_instruction(std::string s,
-                                   std::initializer_list<Qubit> ctrl_list,
-                                   Qubit q,
-                                   Ts... args);
+    // Sample the results measured by the current prefix
+    QState sample_result(Result) const;
+
+    // Execute the current prefix and append its samples
+    void execute_prefix(std::vector<int> const& qubits,
+                        VecSample* samples) const;
+
+    // Get the key of the current circuit prefix
+    PrefixKey prefix_key() const { return {ops_.size(), ops_hash_}; }
+
+    // Get the cache key of the circuit built by an entry point
+    std::string cache_key(EntryPointAttrs const& attrs) const;
+
+    // Find a cached circuit in memory or on disk
+    std::shared_ptr<xacc::CompositeInstruction>
+    load_circuit(std::string const& key);
+
+    // Save the current circuit to the cache
+    void store_circuit(std::string const& key);
+
+    // Record a gate in the current circuit
+    void add_op(Gate gate, std::initializer_list<Qubit> qs, double param = 0);
+
+    // Add XACC instructions for the recorded gates to the current circuit
+    void flush_ops() const;
+
+    // Add the decomposition of a Toffoli gate
+    void append_ccx(Op const& op, VecInstruction* instructions) const;
+
+    // Determine the gates supported by the accelerator
+    Capabilities query_capabilities(std::string const& accel_name) const;
+
+    // Get the name and number of qubits of a gate
+    static char const* to_xacc_name(Gate gate);
+    static std::size_t num_gate_qubits(Gate gate);
 };
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,43 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirxacc/XaccShotRuntime.cc
+//---------------------------------------------------------------------------//
+#include "XaccShotRuntime.hh"
+
+#include <iostream>
+
+#include "qiree/Assert.hh"
+
+#include "XaccQuantum.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with quantum reference to access classical registers.
+ */
+XaccShotRuntime::XaccShotRuntime(std::ostream& output,
+                                 XaccQuantum const& xacc)
+    : SingleResultRuntime{xacc}, output_(output)
+{
+    QIREE_VALIDATE(xacc.options().dynamic,
+                   << "XACC must be in dynamic mode to record single shots");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize the execution environment, resetting qubits.
+ */
+void XaccShotRuntime::initialize(OptionalCString env)
+{
+    if (env)
+    {
+        output_ << "Argument to initialize: " << env << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,44 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirxacc/XaccShotRuntime.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include "qiree/SingleResultRuntime.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+class XaccQuantum;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record the results of a single shot run by XACC in dynamic mode.
+ *
+ * Unlike \c XaccDefaultRuntime and \c XaccTupleRuntime, which print the
+ * statistics of a single many-shot execution, this records the results read
+ * from the quantum interface so that a \c ShotScheduler can accumulate them.
+ */
+class XaccShotRuntime final : virtual public SingleResultRuntime
+{
+  public:
+    // Construct with quantum reference to access classical registers
+    XaccShotRuntime(std::ostream& output, XaccQuantum const& xacc);
+
+    //!@{
+    //! \name Runtime interface
+
+    // Initialize the execution environment, resetting qubits
+    void initialize(OptionalCString env) override;
+
+    //!@}
+
+  private:
+    std::ostream& output_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -7,7 +7,10 @@
 //---------------------------------------------------------------------------//
 #include "XaccTupleRuntime.hh"
 
+#include <iostream>
+
 #include "qiree/Assert.hh"
+#include "qiree/ResultSink.hh"
 
 namespace qiree
 {
@@ -16,14 +19,19 @@ namespace qiree
  * Construct an \c XaccTupleRuntime.
  *
  * The \c print_accelbuf argument determines whether the XACC \c
- * AcceleratorBuffer is dumped after execution.
+ * AcceleratorBuffer is dumped after execution. Results are written to the
+ * optional \c sink rather than printed, in which case the buffer is never
+ * dumped and diagnostics are written to \c std::clog so that only records
+ * reach the sink's stream.
  */
 XaccTupleRuntime::XaccTupleRuntime(std::ostream& output,
                                    XaccQuantum& xacc,
-                                   bool print_accelbuf)
+                                   bool print_accelbuf,
+                                   ResultSink* sink)
     : output_(output)
     , xacc_(xacc)
-    , print_accelbuf_(print_accelbuf)
+    , print_accelbuf_(print_accelbuf && !sink)
+    , sink_(sink)
     , valid_(false)
 {
 }
@@ -36,7 +44,9 @@ void XaccTupleRuntime::initialize(OptionalCString env)
 {
     if (env)
     {
-        output_ << "Argument to initialize: " << env << std::endl;
+        // Keep the output stream free of text when writing records to it
+        (sink_ ? std::clog : output_)
+            << "Argument to initialize: " << env << std::endl;
     }
 }
 
@@ -125,19 +135,32 @@ void XaccTupleRuntime::push_result(Qubit q)
 
 void XaccTupleRuntime::print_header(size_type num_distinct)
 {
+    if (sink_)
+    {
+        return;
+    }
     output_ << to_cstring(type_) << " " << tag_ << " length " << qubits_.size()
-            << " distinct results " << num_distinct << std::endl;
+            << " distinct results " << num_distinct << '\n';
 }
 
 void XaccTupleRuntime::finish_tuple()
 {
     auto counts = xacc_.get_marginal_counts(qubits_);
+    if (sink_)
+    {
+        for (auto& [bits, count] : counts)
+        {
+            sink_->write(tag_, bits, static_cast<size_type>(count));
+        }
+        valid_ = false;
+        return;
+    }
     this->print_header(counts.size());
     auto name = to_cstring(type_);
     for (auto& [bits, count] : counts)
     {
         output_ << name << " " << tag_ << " result " << bits << " count "
-                << count << std::endl;
+                << count << '\n';
     }
     valid_ = false;
 }
@@ -11,6 +11,7 @@
 
 namespace qiree
 {
+class ResultSink;
 class XaccQuantum;
 
 //---------------------------------------------------------------------------//
@@ -25,6 +26,9 @@ class XaccQuantum;
  * tuple ret result 00 count 512
  * tuple ret result 11 count 512
  * \endcode
+ *
+ * If a \c ResultSink is given, each distinct result of a tuple is instead
+ * written to it as a record labeled with the tuple's tag.
  */
 class XaccTupleRuntime final : virtual public RuntimeInterface
 {
@@ -32,7 +36,8 @@ class XaccTupleRuntime final : virtual public RuntimeInterface
     // Construct with XACC quantum runtime and options
     XaccTupleRuntime(std::ostream& output,
                      XaccQuantum& xacc,
-                     bool print_accelbuf);
+                     bool print_accelbuf,
+                     ResultSink* sink = nullptr);
 
     //!@{
     //! \name Runtime interface
@@ -61,6 +66,7 @@ class XaccTupleRuntime final : virtual public RuntimeInterface
     std::ostream& output_;
     XaccQuantum& xacc_;
     bool const print_accelbuf_;
+    ResultSink* sink_;
     bool valid_;
     GroupingType type_;
     std::string tag_;
@@ -32,6 +32,7 @@ DECLARE_FUNCPTR(num_quantum_reg);
 DECLARE_FUNCPTR(num_classical_reg);
 DECLARE_FUNCPTR(max_result_items);
 DECLARE_FUNCPTR(setup_executor);
+DECLARE_FUNCPTR(set_num_threads);
 DECLARE_FUNCPTR(execute);
 DECLARE_FUNCPTR(save_result_items);
 DECLARE_FUNCPTR(destroy);
@@ -59,6 +60,7 @@ class CQireeTest : public ::qiree::test::Test
         LOAD_FUNCPTR(num_classical_reg);
         LOAD_FUNCPTR(max_result_items);
         LOAD_FUNCPTR(setup_executor);
+        LOAD_FUNCPTR(set_num_threads);
         LOAD_FUNCPTR(execute);
         LOAD_FUNCPTR(save_result_items);
         LOAD_FUNCPTR(destroy);
@@ -86,6 +88,7 @@ class CQireeTest : public ::qiree::test::Test
     qiree_num_classical_reg_t num_classical_reg_fn_ = nullptr;
     qiree_max_result_items_t max_result_items_fn_ = nullptr;
     qiree_setup_executor_t setup_executor_fn_ = nullptr;
+    qiree_set_num_threads_t set_num_threads_fn_ = nullptr;
     qiree_execute_t execute_fn_ = nullptr;
     qiree_save_result_items_t save_result_items_fn_ = nullptr;
     qiree_destroy_t destroy_fn_ = nullptr;
@@ -211,6 +214,48 @@ TEST_F(CQireeTest, Run)
     result = max_result_items_fn_(manager, 1000, nullptr);
     EXPECT_EQ(result, QIREE_INVALID_INPUT);
 
+    result = set_num_threads_fn_(nullptr, 1);
+    EXPECT_EQ(result, QIREE_NOT_READY);
+
+    result = set_num_threads_fn_(manager, -1);
+    EXPECT_EQ(result, QIREE_INVALID_INPUT);
+
+    // Malformed configuration is rejected
+    result = setup_executor_fn_(manager, "qsim", R"({"max_fused_size": )");
+    EXPECT_EQ(result, QIREE_FAIL_LOAD);
+    result = setup_executor_fn_(manager, "qsim", R"({"fused": {}})");
+    EXPECT_EQ(result, QIREE_FAIL_LOAD);
+
+    // Configuration is validated as JSON before the backend is chosen
+    auto config_error = [&](char const* config) {
+        ::testing::internal::CaptureStderr();
+        result = setup_executor_fn_(manager, "none", config);
+        EXPECT_EQ(result, QIREE_FAIL_LOAD);
+        auto msg = ::testing::internal::GetCapturedStderr();
+        return msg.find("invalid JSON configuration") != std::string::npos;
+    };
+    for (auto const* config : {R"({"a": 01})",
+                               R"({"a": 1.})",
+                               R"({"a": -})",
+                               R"({"a": tru})",
+                               R"({"a": true1})",
+                               R"({"a": null})",
+                               R"({"a": [1]})",
+                               R"({"a": "\x"})",
+                               R"({"a": "\ud800"})",
+                               R"({'a': 1})",
+                               R"({"a": 1,})",
+                               R"({"a": 1} x)"})
+    {
+        EXPECT_TRUE(config_error(config)) << config;
+    }
+    for (auto const* config : {R"({})",
+                               R"( {"a": -1.5e+3, "b": false} )",
+                               R"({"a": "q\"\\\u00e9\ud83d\ude00"})"})
+    {
+        EXPECT_FALSE(config_error(config)) << config;
+    }
+
     if (!QIREE_USE_QSIM)
     {
         GTEST_SKIP() << "Cannot test cqiree execution: QSim is disabled";
@@ -0,0 +1,42 @@
+; ModuleID = 'unreachable'
+source_filename = "unreachable"
+
+%Qubit = type opaque
+%Result = type opaque
+
+@Unused__FunctionTable = internal constant [1 x void (%Qubit*)*] [void (%Qubit*)* @Unused__body]
+
+define void @main() #0 {
+entry:
+  call void @Bell__body(%Qubit* null, %Qubit* nonnull inttoptr (i64 1 to %Qubit*))
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  call void @__quantum__qis__mz__body(%Qubit* nonnull inttoptr (i64 1 to %Qubit*), %Result* nonnull inttoptr (i64 1 to %Result*))
+  call void @__quantum__rt__array_record_output(i64 2, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* nonnull inttoptr (i64 1 to %Result*), i8* null)
+  ret void
+}
+
+define internal void @Bell__body(%Qubit* %q1, %Qubit* %q2) {
+entry:
+  call void @__quantum__qis__h__body(%Qubit* %q1)
+  call void @__quantum__qis__cnot__body(%Qubit* %q1, %Qubit* %q2)
+  ret void
+}
+
+; Never called by the entry point
+define internal void @Unused__body(%Qubit* %q) {
+entry:
+  call void @__quantum__qis__unsupported__body(%Qubit* %q)
+  ret void
+}
+
+declare void @__quantum__qis__h__body(%Qubit*)
+declare void @__quantum__qis__cnot__body(%Qubit*, %Qubit*)
+declare void @__quantum__qis__unsupported__body(%Qubit*)
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+declare void @__quantum__rt__array_record_output(i64, i8*)
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "num_required_qubits"="2" "num_required_results"="2" "output_labeling_schema" "qir_profiles"="custom" }
+attributes #1 = { "irreversible" }
@@ -7,6 +7,11 @@
 //---------------------------------------------------------------------------//
 #include "qiree/Executor.hh"
 
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 #include "QuantumTestImpl.hh"
 #include "qiree/Assert.hh"
 #include "qiree/Module.hh"
@@ -232,6 +237,50 @@ tear_down
               result.commands.str());
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, multiple_functions)
+{
+    // Internal entry point calling internal functions, each compiled lazily
+    auto result = this->run("multiple.ll");
+    EXPECT_EQ(R"(
+set_up(q=2, r=2)
+h(Q{0})
+h(Q{1})
+cnot(Q{0}, Q{1})
+h(Q{0})
+h(Q{1})
+cnot(Q{0}, Q{1})
+mz(Q{0},R{0})
+array_record_output(1)
+result_record_output(R{0})
+tear_down
+)",
+              result.commands.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, unreachable)
+{
+    // The text module is read completely
+    EXPECT_THROW(this->run("unreachable.ll"), DebugError);
+
+    // Functions not called by the entry point of a bitcode module are never
+    // read, so they may call unsupported functions
+    auto result = this->run("unreachable.bc");
+    EXPECT_EQ(R"(
+set_up(q=2, r=2)
+h(Q{0})
+cnot(Q{0}, Q{1})
+mz(Q{0},R{0})
+mz(Q{1},R{1})
+array_record_output(2)
+result_record_output(R{0})
+result_record_output(R{1})
+tear_down
+)",
+              result.commands.str());
+}
+
 //---------------------------------------------------------------------------//
 TEST_F(ExecutorTest, teleport)
 {
@@ -259,6 +308,155 @@ tear_down
     // cout << result.commands.str();
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, multithreaded)
+{
+    Executor execute(Module(this->test_data_path("bell.ll")));
+
+    constexpr int num_threads = 4;
+    constexpr int num_shots = 8;
+    std::vector<TestResult> results(num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&execute, &tr = results[t]] {
+            QuantumTestImpl quantum_impl(&tr);
+            ResultTestImpl result_impl(&tr);
+            for (int i = 0; i < num_shots; ++i)
+            {
+                execute(quantum_impl, result_impl);
+            }
+        });
+    }
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+
+    std::string expected = "\n";
+    for (int i = 0; i < num_shots; ++i)
+    {
+        expected += R"(set_up(q=2, r=2)
+h(Q{0})
+cnot(Q{0}, Q{1})
+mz(Q{0},R{0})
+mz(Q{1},R{1})
+array_record_output(2)
+result_record_output(R{0})
+result_record_output(R{1})
+tear_down
+)";
+    }
+    for (auto const& tr : results)
+    {
+        EXPECT_EQ(expected, tr.commands.str());
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, object_cache)
+{
+    Executor::Options opts;
+    opts.object_cache_dir = ::testing::TempDir() + "qiree-object-cache";
+
+    auto run_cached = [&] {
+        Executor execute(Module(this->test_data_path("multiple.ll")), opts);
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        execute(quantum_impl, result_impl);
+        return std::make_pair(execute.object_from_cache(), tr.commands.str());
+    };
+
+    // The first run may or may not use an object from a previous test run
+    auto [first_cached, first] = run_cached();
+    auto [second_cached, second] = run_cached();
+    EXPECT_TRUE(second_cached);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(std::string::npos, second.find("cnot(Q{0}, Q{1})"));
+
+    // The module is hashed for interfaces only on request
+    auto path = this->test_data_path("bell.ll");
+    EXPECT_EQ("", Executor(Module(path)).entry_point_attrs().module_hash);
+    opts = {};
+    opts.hash_module = true;
+    EXPECT_EQ(Module(path).content_hash(),
+              Executor(Module(path), opts).entry_point_attrs().module_hash);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, optimized)
+{
+    auto run_at = [this](char const* filename, Module::OptLevel level) {
+        Executor::Options opts;
+        opts.opt_level = level;
+        Executor execute(Module(this->test_data_path(filename), "main"), opts);
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        execute(quantum_impl, result_impl);
+        return tr.commands.str();
+    };
+
+    using OL = Module::OptLevel;
+    for (char const* filename : {"loop.ll", "multiple.ll", "teleport.ll"})
+    {
+        auto expected = run_at(filename, OL::O0);
+        for (auto level : {OL::O1, OL::O2, OL::O3, OL::qir})
+        {
+            EXPECT_EQ(expected, run_at(filename, level))
+                << "in " << filename << " at " << to_cstring(level);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, direct_runtime)
+{
+    auto run_with = [](Module&& m, bool direct) {
+        Executor::Options opts;
+        opts.direct_runtime = direct;
+        Executor execute(std::move(m), opts);
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        execute(quantum_impl, result_impl);
+        return tr.commands.str();
+    };
+
+    // Results are read by the host between buffered operations in teleport
+    for (char const* filename : {"bell.ll",
+                                 "multiple.ll",
+                                 "pyqir_several_gates.ll",
+                                 "rotation.ll",
+                                 "teleport.ll"})
+    {
+        auto path = this->test_data_path(filename);
+        EXPECT_EQ(run_with(Module(path), false), run_with(Module(path), true))
+            << "in " << filename;
+    }
+
+    // Apply more operations than the buffer holds
+    std::string ir;
+    {
+        std::ifstream infile(this->test_data_path("loop.ll"));
+        std::ostringstream os;
+        os << infile.rdbuf();
+        ir = os.str();
+    }
+    auto replace = [&ir](std::string const& from, std::string const& to) {
+        auto pos = ir.find(from);
+        ASSERT_NE(std::string::npos, pos) << from;
+        ir.replace(pos, from.size(), to);
+    };
+    replace("i64 %0, 6", "i64 %0, 1001");
+    replace("\"EntryPoint\"", "\"entry_point\"");
+    auto expected = run_with(std::move(*Module::from_bytes(ir)), false);
+    auto actual = run_with(std::move(*Module::from_bytes(ir)), true);
+    EXPECT_EQ(expected, actual);
+    EXPECT_NE(std::string::npos, actual.find("mz(Q{0},R{0})"));
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
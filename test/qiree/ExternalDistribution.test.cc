@@ -0,0 +1,140 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ExternalDistribution.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/ExternalDistribution.hh"
+
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "qiree/Assert.hh"
+#include "qiree/RecordedResult.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+class ExternalDistributionTest : public ::testing::Test
+{
+  protected:
+    std::string const filename_{::testing::TempDir() + "dist.runs"};
+
+    //! Generate pseudorandom results with a skewed distribution
+    static std::vector<RecordedResult> make_results(size_type num_shots,
+                                                    size_type num_bits)
+    {
+        std::mt19937 rng{12345};
+        std::geometric_distribution<unsigned int> sample{0.05};
+        std::vector<RecordedResult> result;
+        for (size_type i = 0; i < num_shots; ++i)
+        {
+            unsigned int value = sample(rng);
+            std::vector<bool> bits(num_bits);
+            for (size_type b = 0; b < num_bits; ++b)
+            {
+                // Spread the value across both words of a 70-bit key
+                bits[b] = (value >> (b % 32)) & (b < 32 || b >= 64);
+            }
+            result.emplace_back(std::move(bits));
+        }
+        return result;
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ExternalDistributionTest, spill_and_merge)
+{
+    auto const results = make_results(2000, 70);
+
+    ResultDistribution expected;
+    for (auto const& r : results)
+    {
+        expected.accumulate(r);
+    }
+
+    {
+        // Hold at most 16 keys in memory
+        ExternalDistribution dist{filename_, 16 * 2 * 3 * 8};
+        for (auto const& r : results)
+        {
+            dist.accumulate(r);
+        }
+        EXPECT_GT(dist.num_runs(), 2);
+        EXPECT_EQ(70, dist.num_bits());
+        EXPECT_EQ(2000, dist.num_shots());
+
+        size_type num_keys = 0;
+        size_type num_shots = 0;
+        std::string prev;
+        dist.for_each_packed([&](auto const* key, size_type count) {
+            auto bits = dist.to_string(key);
+            EXPECT_EQ(expected.count(bits), count) << bits;
+            ++num_keys;
+            num_shots += count;
+        });
+        EXPECT_EQ(expected.size(), num_keys);
+        EXPECT_EQ(2000, num_shots);
+
+        // Merging a distribution adds to the existing counts
+        dist.merge(expected);
+        auto top = dist.top(3);
+        ASSERT_EQ(3, top.size());
+        EXPECT_EQ(2 * expected.count(top[0].first), top[0].second);
+        EXPECT_GE(top[0].second, top[1].second);
+        EXPECT_GE(top[1].second, top[2].second);
+
+        // Results with mismatched lengths are rejected
+        EXPECT_THROW(dist.accumulate(RecordedResult({true})), RuntimeError);
+    }
+
+    // Scratch file is deleted
+    EXPECT_FALSE(std::ifstream{filename_});
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExternalDistributionTest, top_and_marginal)
+{
+    ExternalDistribution dist{filename_, 1024};
+    auto add = [&dist](std::vector<bool> bits, size_type count) {
+        for (size_type i = 0; i < count; ++i)
+        {
+            dist.accumulate(RecordedResult{RecordedResult::VecBits(bits)});
+        }
+    };
+    add({true, false, true}, 5);
+    add({false, false, false}, 2);
+    add({true, true, false}, 3);
+    dist.spill();
+    add({true, false, true}, 1);
+    add({false, true, true}, 3);
+    EXPECT_EQ(1, dist.num_runs());
+
+    auto top = dist.top(3);
+    ASSERT_EQ(3, top.size());
+    EXPECT_EQ("101", top[0].first);
+    EXPECT_EQ(6, top[0].second);
+    // Ties are ordered by packed key, i.e. by the reversed bit string
+    EXPECT_EQ("110", top[1].first);
+    EXPECT_EQ(3, top[1].second);
+    EXPECT_EQ("011", top[2].first);
+    EXPECT_EQ(3, top[2].second);
+    EXPECT_EQ(4, dist.top(10).size());
+    EXPECT_TRUE(dist.top(0).empty());
+
+    auto marginal = dist.marginal({2, 0});
+    ExternalDistribution::MapCount const expected_marginal{
+        {"00", 2}, {"01", 3}, {"10", 3}, {"11", 6}};
+    EXPECT_EQ(expected_marginal, marginal);
+
+    EXPECT_THROW(dist.marginal({3}), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
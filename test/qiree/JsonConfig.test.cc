@@ -0,0 +1,124 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/JsonConfig.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/JsonConfig.hh"
+
+#include <string>
+
+#include "qiree/Assert.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+TEST(JsonConfigTest, empty)
+{
+    EXPECT_TRUE(parse_json_config("{}").empty());
+    EXPECT_TRUE(parse_json_config(" \t\r\n{ \n}\n").empty());
+}
+
+TEST(JsonConfigTest, scalars)
+{
+    auto items = parse_json_config(
+        R"({"isa": "avx2", "num_threads" : 4, "affinity":"compact",)"
+        R"( "direct_runtime": true, "replay": false})");
+    ConfigItems expected{{"isa", "avx2"},
+                         {"num_threads", "4"},
+                         {"affinity", "compact"},
+                         {"direct_runtime", "true"},
+                         {"replay", "false"}};
+    EXPECT_EQ(expected, items);
+}
+
+TEST(JsonConfigTest, numbers)
+{
+    // Numbers are kept verbatim
+    for (char const* num : {"0", "-0", "12", "-3", "1.5", "0.25", "1e3",
+                            "2E-2", "-4.5e+10"})
+    {
+        std::string json = std::string{R"({"x": )"} + num + "}";
+        auto items = parse_json_config(json);
+        ASSERT_EQ(1, items.size()) << json;
+        EXPECT_EQ(num, items.front().second) << json;
+    }
+    for (char const* num : {"01", "+1", "1.", ".5", "1e", "1e+", "-", "0x10"})
+    {
+        std::string json = std::string{R"({"x": )"} + num + "}";
+        EXPECT_THROW(parse_json_config(json), RuntimeError) << json;
+    }
+}
+
+TEST(JsonConfigTest, escapes)
+{
+    auto items = parse_json_config(
+        R"({"path": "a\"b\\c\/d\b\f\n\r\t", "u": "\u0041\u00e9\u20AC",)"
+        R"( "pair": "\ud83d\ude00", "k\u0065y": "v"})");
+    ASSERT_EQ(4, items.size());
+    EXPECT_EQ("a\"b\\c/d\b\f\n\r\t", items[0].second);
+    EXPECT_EQ("A\xc3\xa9\xe2\x82\xac", items[1].second);
+    EXPECT_EQ("\xf0\x9f\x98\x80", items[2].second);
+    EXPECT_EQ("key", items[3].first);
+
+    for (char const* json : {
+             R"({"x": "\q"})",  // unknown escape
+             R"({"x": "\u00g0"})",  // bad hex digit
+             R"({"x": "\u12"})",  // truncated
+             R"({"x": "\ud83d"})",  // unpaired high surrogate
+             R"({"x": "\ud83dA"})",  // invalid low surrogate
+             R"({"x": "\ude00"})",  // lone low surrogate
+             "{\"x\": \"a\tb\"}",  // unescaped control character
+             R"({"x": "abc})",  // unterminated
+         })
+    {
+        EXPECT_THROW(parse_json_config(json), RuntimeError) << json;
+    }
+}
+
+TEST(JsonConfigTest, rejected)
+{
+    for (char const* json : {
+             "",
+             "[]",
+             R"("x")",
+             R"({"x": 1)",
+             R"({"x": 1,})",
+             R"({"x" 1})",
+             R"({x: 1})",
+             R"({'x': 1})",
+             R"({"x": 1} {})",
+             R"({"x": 1}x)",
+             R"({"x": TRUE})",
+             R"({"x": nope})",
+             R"({"x": null})",
+             R"({"x": [1]})",
+             R"({"x": {"y": 1}})",
+         })
+    {
+        EXPECT_THROW(parse_json_config(json), RuntimeError) << json;
+    }
+
+    // The error identifies the input and the location
+    try
+    {
+        parse_json_config(R"({"x": null})");
+        FAIL() << "expected an error";
+    }
+    catch (RuntimeError const& e)
+    {
+        std::string msg = e.what();
+        EXPECT_NE(std::string::npos, msg.find("invalid JSON configuration"))
+            << msg;
+        EXPECT_NE(std::string::npos, msg.find("position 6")) << msg;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
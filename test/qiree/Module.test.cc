@@ -11,7 +11,10 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "qiree/Assert.hh"
 #include "qiree_test.hh"
 
 namespace qiree
@@ -38,6 +41,7 @@ TEST_F(ModuleTest, minimal)
     EXPECT_EQ(0, attrs.required_num_results);
     EXPECT_EQ("", attrs.output_labeling_schema);
     EXPECT_EQ("custom", attrs.qir_profiles);
+    EXPECT_EQ("main", attrs.entry_point);
 
     // Test module flags
     auto flags = m.load_module_flags();
@@ -114,6 +118,93 @@ TEST_F(ModuleTest, several_gates)
     EXPECT_FALSE(flags.dynamic_result_management);
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, analyze)
+{
+    using VecStr = std::vector<std::string>;
+    {
+        // Straight-line circuit with terminal measurements
+        auto a = Module(this->test_data_path("bell.ll")).analyze();
+        EXPECT_EQ(1, a.num_blocks);
+        EXPECT_FALSE(a.has_branches);
+        EXPECT_FALSE(a.has_loops);
+        EXPECT_FALSE(a.has_internal_calls);
+        EXPECT_TRUE(a.straight_line);
+        EXPECT_EQ(2, a.num_measurements);
+        EXPECT_TRUE(a.terminal_measurements);
+        EXPECT_FALSE(a.reads_results);
+        EXPECT_FALSE(a.result_feedback);
+        EXPECT_EQ((VecStr{"__quantum__qis__cnot__body",
+                          "__quantum__qis__h__body",
+                          "__quantum__qis__mz__body"}),
+                  a.qis_functions);
+    }
+    {
+        // Results are read but unused; gates follow measurements
+        auto a = Module(this->test_data_path("dynamicbv.ll")).analyze();
+        EXPECT_TRUE(a.straight_line);
+        EXPECT_FALSE(a.terminal_measurements);
+        EXPECT_TRUE(a.reads_results);
+        EXPECT_FALSE(a.result_feedback);
+    }
+    {
+        // Loop with a classical counter
+        auto a = Module(this->test_data_path("loop.ll")).analyze();
+        EXPECT_EQ(4, a.num_blocks);
+        EXPECT_TRUE(a.has_branches);
+        EXPECT_TRUE(a.has_loops);
+        EXPECT_FALSE(a.straight_line);
+        EXPECT_FALSE(a.terminal_measurements);
+        EXPECT_FALSE(a.reads_results);
+        EXPECT_FALSE(a.result_feedback);
+    }
+    {
+        // Branches on measurement results
+        auto a = Module(this->test_data_path("teleport.ll")).analyze();
+        EXPECT_TRUE(a.has_branches);
+        EXPECT_FALSE(a.has_loops);
+        EXPECT_TRUE(a.reads_results);
+        EXPECT_TRUE(a.result_feedback);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, optimize)
+{
+    {
+        // Constant trip count loop is fully unrolled
+        Module m(this->test_data_path("loop.ll"), "main");
+        m.optimize(Module::OptLevel::O2);
+        auto a = m.analyze();
+        EXPECT_EQ(1, a.num_blocks);
+        EXPECT_FALSE(a.has_loops);
+        EXPECT_TRUE(a.straight_line);
+    }
+    {
+        // Internal subroutines are inlined into the entry point
+        Module m(this->test_data_path("multiple.ll"));
+        m.optimize(Module::OptLevel::qir);
+        auto a = m.analyze();
+        EXPECT_FALSE(a.has_internal_calls);
+        EXPECT_TRUE(a.straight_line);
+        EXPECT_EQ(1, a.num_measurements);
+    }
+    {
+        // Branches on measurement results remain
+        Module m(this->test_data_path("teleport.ll"));
+        m.optimize(Module::OptLevel::qir);
+        auto a = m.analyze();
+        EXPECT_TRUE(a.has_branches);
+        EXPECT_TRUE(a.result_feedback);
+    }
+
+    for (auto name : {"O0", "O1", "O2", "O3", "qir"})
+    {
+        EXPECT_STREQ(name, to_cstring(to_opt_level(name)));
+    }
+    EXPECT_THROW(to_opt_level("Ofast"), RuntimeError);
+}
+
 //---------------------------------------------------------------------------//
 TEST_F(ModuleTest, parse_ir_from_file)
 {
@@ -141,6 +232,59 @@ TEST_F(ModuleTest, parse_ir_from_file)
         << "QIR should contain a !llvm.module.flags metadata node";
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, bitcode)
+{
+    std::string const path = this->test_data_path("unreachable.bc");
+    {
+        // Only the entry point and the function it calls are read
+        Module m(path);
+        EXPECT_TRUE(m);
+        EXPECT_EQ(2, m.load_entry_point_attrs().required_num_qubits);
+        auto a = m.analyze();
+        EXPECT_TRUE(a.has_internal_calls);
+        EXPECT_EQ(2, a.num_measurements);
+        EXPECT_EQ(32, m.content_hash().size());
+    }
+    {
+        // Bytes are only needed while parsing
+        std::string bytes;
+        {
+            std::ifstream infile(path, std::ios::binary);
+            std::ostringstream os;
+            os << infile.rdbuf();
+            bytes = os.str();
+        }
+        auto m = Module::from_bytes(std::string_view{bytes});
+        ASSERT_TRUE(m && *m);
+        EXPECT_EQ(Module(path).content_hash(), m->content_hash());
+        bytes.assign(bytes.size(), '\0');
+        EXPECT_EQ(2, m->analyze().num_measurements);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, content_hash)
+{
+    std::string bell_hash = Module(this->test_data_path("bell.ll"))
+                                .content_hash();
+    EXPECT_EQ(32, bell_hash.size());
+
+    // The hash does not depend on where the module was loaded from
+    std::ifstream infile(this->test_data_path("bell.ll"));
+    std::ostringstream buf;
+    buf << infile.rdbuf();
+    EXPECT_EQ(bell_hash, Module::from_bytes(buf.str())->content_hash());
+
+    EXPECT_NE(bell_hash,
+              Module(this->test_data_path("bell_ccx.ll")).content_hash());
+
+    // The hash is of the input, not the optimized IR
+    Module m(this->test_data_path("bell.ll"));
+    m.optimize(Module::OptLevel::O2);
+    EXPECT_EQ(bell_hash, m.content_hash());
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
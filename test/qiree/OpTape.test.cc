@@ -0,0 +1,90 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/OpTape.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/OpTape.hh"
+
+#include "QuantumTestImpl.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/OpRecorder.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class OpTapeTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(OpTapeTest, record_replay)
+{
+    for (char const* filename : {"bell.ll", "rotation.ll", "teleport.ll"})
+    {
+        SCOPED_TRACE(filename);
+        Executor execute(Module(this->test_data_path(filename)));
+
+        // Record while executing
+        TestResult expected;
+        OpTape tape;
+        {
+            QuantumTestImpl quantum_impl(&expected);
+            ResultTestImpl result_impl(&expected);
+            OpRecorder record{quantum_impl, result_impl, tape};
+            execute(record, record);
+            tape.finish();
+        }
+        EXPECT_TRUE(tape.complete());
+        EXPECT_TRUE(tape.replayable());
+        EXPECT_GT(tape.size(), 0);
+
+        // Replaying issues the same sequence of calls
+        TestResult actual;
+        QuantumTestImpl quantum_impl(&actual);
+        ResultTestImpl result_impl(&actual);
+        tape.replay(execute.entry_point_attrs(), quantum_impl, result_impl);
+        EXPECT_EQ(expected.commands.str(), actual.commands.str());
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(OpTapeTest, unsupported)
+{
+    TestResult tr;
+    QuantumTestImpl quantum_impl(&tr);
+    ResultTestImpl result_impl(&tr);
+
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+
+    OpTape tape;
+    OpRecorder record{quantum_impl, result_impl, tape};
+    record.set_up(attrs);
+    record.h(Qubit{0});
+    record.h(Array{0}, Qubit{1});
+    record.tear_down();
+    tape.finish();
+    EXPECT_EQ(1, tape.size());
+    EXPECT_TRUE(tape.complete());
+    EXPECT_FALSE(tape.replayable());
+
+    // Setting up again clears the tape
+    record.set_up(attrs);
+    EXPECT_EQ(0, tape.size());
+    EXPECT_FALSE(tape.complete());
+    record.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,51 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/RecordedResult.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/RecordedResult.hh"
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+TEST(RecordedResultTest, reset)
+{
+    char const label[] = "array";
+    RecordedResult result(3, label);
+    result.push_back(QState::one, "foo");
+    result.push_back(QState::zero);
+    result.push_back(QState::one, "baz");
+
+    EXPECT_EQ("array", result.container_label());
+    EXPECT_EQ((std::vector<bool>{true, false, true}), result.bits());
+    EXPECT_EQ((std::vector<std::string_view>{"foo", "", "baz"}),
+              result.entry_labels());
+
+    // Labels are not copied
+    EXPECT_EQ(label, result.container_label().data());
+
+    // Resetting keeps the storage
+    auto const* labels_data = result.entry_labels().data();
+    auto bits_capacity = result.bits().capacity();
+    result.reset(2, nullptr);
+    EXPECT_EQ("", result.container_label());
+    EXPECT_TRUE(result.bits().empty());
+    EXPECT_TRUE(result.entry_labels().empty());
+    EXPECT_EQ(bits_capacity, result.bits().capacity());
+
+    result.push_back(QState::zero, "bar");
+    result.push_back(QState::one, "baz");
+    EXPECT_EQ((std::vector<bool>{false, true}), result.bits());
+    EXPECT_EQ(labels_data, result.entry_labels().data());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -7,6 +7,11 @@
 //---------------------------------------------------------------------------//
 #include "qiree/ResultDistribution.hh"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "qiree/Assert.hh"
 #include "qiree/RecordedResult.hh"
 #include "qiree_test.hh"
@@ -95,6 +100,79 @@ TEST(ResultDistributionTest, ToJsonProducesValidJson)
     EXPECT_NE(json.find("\"011\":1"), std::string::npos);
 }
 
+// Test merging distributions from separate accumulators.
+TEST(ResultDistributionTest, Merge)
+{
+    ResultDistribution dist;
+    dist.accumulate(RecordedResult({true, false, true}));  // "101"
+    dist.accumulate(RecordedResult({false, true, true}));  // "011"
+
+    ResultDistribution other;
+    other.accumulate(RecordedResult({true, false, true}));  // "101"
+    other.accumulate(RecordedResult({true, true, true}));  // "111"
+
+    dist.merge(other);
+    EXPECT_EQ(3u, dist.size());
+    EXPECT_EQ(2u, dist.count("101"));
+    EXPECT_EQ(1u, dist.count("011"));
+    EXPECT_EQ(1u, dist.count("111"));
+
+    // Merging an empty distribution does nothing
+    dist.merge(ResultDistribution{});
+    EXPECT_EQ(3u, dist.size());
+
+    // Merging into an empty distribution copies it
+    ResultDistribution empty;
+    empty.merge(other);
+    EXPECT_EQ(1u, empty.count("111"));
+
+    // Merging mismatched lengths throws
+    ResultDistribution invalid;
+    invalid.accumulate(RecordedResult({true, false}));
+    EXPECT_THROW(dist.merge(invalid), RuntimeError);
+}
+
+// Test access to packed keys, including keys spanning multiple words.
+TEST(ResultDistributionTest, PackedKeys)
+{
+    ResultDistribution dist;
+    dist.accumulate(RecordedResult({true, true, false, true}));  // "1101"
+    EXPECT_EQ(4u, dist.num_bits());
+    EXPECT_EQ(1u, dist.num_words());
+    dist.for_each_packed([](std::uint64_t const* key, std::size_t count) {
+        EXPECT_EQ(0b1011u, key[0]);
+        EXPECT_EQ(1u, count);
+    });
+
+    // Many distinct keys force the table to grow
+    std::vector<bool> bits(130);
+    ResultDistribution wide;
+    for (std::size_t i = 0; i < bits.size(); ++i)
+    {
+        bits.assign(bits.size(), false);
+        bits[i] = true;
+        wide.accumulate(RecordedResult(std::vector<bool>(bits)));
+        wide.accumulate(RecordedResult(std::vector<bool>(bits)));
+    }
+    EXPECT_EQ(3u, wide.num_words());
+    EXPECT_EQ(130u, wide.size());
+
+    std::string key(130, '0');
+    key[129] = '1';
+    EXPECT_EQ(2u, wide.count(key));
+    key[64] = '1';
+    EXPECT_EQ(0u, wide.count(key));
+
+    std::size_t total = 0;
+    for (auto const& [k, count] : wide)
+    {
+        EXPECT_EQ(130u, k.size());
+        EXPECT_EQ(1, std::count(k.begin(), k.end(), '1')) << k;
+        total += count;
+    }
+    EXPECT_EQ(260u, total);
+}
+
 // Test behavior on an empty distribution (no accumulation).
 TEST(ResultDistributionTest, CountOnEmptyDistribution)
 {
@@ -105,6 +183,137 @@ TEST(ResultDistributionTest, CountOnEmptyDistribution)
     EXPECT_THROW(dist.count("0"), RuntimeError);
 }
 
+// Test the choice between a dense histogram and a sparse map.
+TEST(ResultDistributionTest, DenseLayoutSelection)
+{
+    RecordedResult const three({true, false, true});
+    EntryPointAttrs attrs;
+    attrs.required_num_results = 3;
+
+    // Without entry point attributes the distribution is sparse
+    ResultDistribution sparse;
+    sparse.accumulate(three);
+    EXPECT_FALSE(sparse.dense());
+
+    // Eight counters fit exactly
+    ResultDistribution fits{attrs, 8 * sizeof(std::size_t)};
+    fits.accumulate(three);
+    EXPECT_TRUE(fits.dense());
+
+    // Falls back to sparse above the memory limit
+    ResultDistribution too_big{attrs, 8 * sizeof(std::size_t) - 1};
+    too_big.accumulate(three);
+    EXPECT_FALSE(too_big.dense());
+    EXPECT_EQ(1u, too_big.count("101"));
+
+    // The default limit of 8 MiB allows at most 20 results
+    attrs.required_num_results = 21;
+    ResultDistribution wide{attrs};
+    wide.accumulate(RecordedResult(std::vector<bool>(21, true)));
+    EXPECT_FALSE(wide.dense());
+    EXPECT_EQ(1u, wide.count(std::string(21, '1')));
+
+    // Recording fewer results than required uses a smaller histogram
+    attrs.required_num_results = 3;
+    ResultDistribution fewer{attrs};
+    fewer.accumulate(RecordedResult({false, true}));
+    EXPECT_TRUE(fewer.dense());
+    EXPECT_EQ(1u, fewer.count("01"));
+
+    // Recording more results than required uses a sparse map
+    ResultDistribution more{attrs};
+    more.accumulate(RecordedResult({false, true, true, true}));
+    EXPECT_FALSE(more.dense());
+    EXPECT_EQ(1u, more.count("0111"));
+}
+
+// Test count, iteration, and serialization of a dense distribution.
+TEST(ResultDistributionTest, DenseAccess)
+{
+    EntryPointAttrs attrs;
+    attrs.required_num_results = 3;
+    ResultDistribution dist{attrs};
+    dist.accumulate(RecordedResult({true, false, true}));  // "101"
+    dist.accumulate(RecordedResult({true, false, true}));  // "101"
+    dist.accumulate(RecordedResult({false, true, true}));  // "011"
+    dist.accumulate(RecordedResult({true, false, false}));  // "100"
+    ASSERT_TRUE(dist.dense());
+
+    EXPECT_EQ(3u, dist.size());
+    EXPECT_EQ(3u, dist.num_bits());
+    EXPECT_EQ(2u, dist.count("101"));
+    EXPECT_EQ(1u, dist.count("011"));
+    EXPECT_EQ(0u, dist.count("111"));
+    EXPECT_THROW(dist.count("10"), RuntimeError);
+
+    // Entries are ordered by packed key, i.e. the first bit varies fastest
+    std::vector<std::pair<std::string, std::size_t>> entries(dist.begin(),
+                                                             dist.end());
+    decltype(entries) expected{{"100", 1}, {"101", 2}, {"011", 1}};
+    EXPECT_EQ(expected, entries);
+    EXPECT_EQ(R"({"100":1,"101":2,"011":1})", dist.to_json());
+}
+
+// Test merging dense distributions with dense and sparse ones.
+TEST(ResultDistributionTest, DenseMerge)
+{
+    EntryPointAttrs attrs;
+    attrs.required_num_results = 3;
+    auto make_dense = [&attrs] {
+        ResultDistribution dist{attrs};
+        dist.accumulate(RecordedResult({true, false, true}));  // "101"
+        dist.accumulate(RecordedResult({false, true, true}));  // "011"
+        EXPECT_TRUE(dist.dense());
+        return dist;
+    };
+    ResultDistribution sparse;
+    sparse.accumulate(RecordedResult({true, false, true}));  // "101"
+    sparse.accumulate(RecordedResult({true, true, true}));  // "111"
+    ASSERT_FALSE(sparse.dense());
+
+    // Dense + dense sums the histograms
+    {
+        ResultDistribution dist = make_dense();
+        ResultDistribution other{attrs};
+        other.accumulate(RecordedResult({true, false, true}));  // "101"
+        other.accumulate(RecordedResult({false, false, false}));  // "000"
+        dist.merge(other);
+        EXPECT_TRUE(dist.dense());
+        EXPECT_EQ(3u, dist.size());
+        EXPECT_EQ(2u, dist.count("101"));
+        EXPECT_EQ(1u, dist.count("011"));
+        EXPECT_EQ(1u, dist.count("000"));
+    }
+
+    // Sparse into dense keeps the dense layout
+    {
+        ResultDistribution dist = make_dense();
+        dist.merge(sparse);
+        EXPECT_TRUE(dist.dense());
+        EXPECT_EQ(3u, dist.size());
+        EXPECT_EQ(2u, dist.count("101"));
+        EXPECT_EQ(1u, dist.count("011"));
+        EXPECT_EQ(1u, dist.count("111"));
+    }
+
+    // Dense into sparse keeps the sparse layout
+    {
+        ResultDistribution dist = sparse;
+        dist.merge(make_dense());
+        EXPECT_FALSE(dist.dense());
+        EXPECT_EQ(3u, dist.size());
+        EXPECT_EQ(2u, dist.count("101"));
+        EXPECT_EQ(1u, dist.count("011"));
+        EXPECT_EQ(1u, dist.count("111"));
+    }
+
+    // Mismatched lengths throw
+    ResultDistribution dist = make_dense();
+    ResultDistribution invalid{attrs};
+    invalid.accumulate(RecordedResult({true, false}));
+    EXPECT_THROW(dist.merge(invalid), RuntimeError);
+}
+
 // Test encode_bit_string for basic functionality
 TEST(EncodeBitString, encoding)
 {
@@ -0,0 +1,108 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultSink.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/ResultSink.hh"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "qiree/Assert.hh"
+#include "qiree/RecordedResult.hh"
+#include "qiree/ResultDistribution.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+TEST(ResultSinkTest, format_names)
+{
+    for (auto format :
+         {ResultFormat::ndjson, ResultFormat::csv, ResultFormat::binary})
+    {
+        EXPECT_EQ(format, to_result_format(to_cstring(format)));
+    }
+    EXPECT_THROW(to_result_format("xml"), RuntimeError);
+}
+
+TEST(ResultSinkTest, ndjson)
+{
+    std::ostringstream os;
+    {
+        auto sink = make_result_sink(ResultFormat::ndjson, os);
+        sink->write("ret", "01", 512);
+        sink->write("say \"hi\"\n", "1", 3);
+
+        // Nothing is written until the sink is flushed
+        EXPECT_EQ("", os.str());
+    }
+    EXPECT_EQ(R"({"label":"ret","bits":"01","count":512}
+{"label":"say \"hi\"\u000a","bits":"1","count":3}
+)",
+              os.str());
+}
+
+TEST(ResultSinkTest, csv)
+{
+    std::ostringstream os;
+    auto sink = make_result_sink(ResultFormat::csv, os);
+    sink->write("ret", "01", 512);
+    sink->write("a,\"b\"", "", 0);
+    sink->flush();
+    EXPECT_EQ("label,bits,count\nret,01,512\n\"a,\"\"b\"\"\",,0\n", os.str());
+}
+
+TEST(ResultSinkTest, binary)
+{
+    std::ostringstream os;
+    make_result_sink(ResultFormat::binary, os)
+        ->write("r", "100000001", 0x0102);
+
+    using namespace std::string_literals;
+    EXPECT_EQ("QIRR\x01\0\0\0"s  // Header
+              "\x01\0\0\0r"s  // Label
+              "\x09\0\0\0\x01\x01"s  // Bits
+              "\x02\x01\0\0\0\0\0\0"s,  // Count
+              os.str());
+}
+
+TEST(ResultSinkTest, distribution)
+{
+    ResultDistribution dist;
+    dist.accumulate(RecordedResult({true, false}));
+    dist.accumulate(RecordedResult({true, false}));
+
+    std::ostringstream os;
+    make_result_sink(ResultFormat::csv, os)->write("", dist);
+    EXPECT_EQ("label,bits,count\n,10,2\n", os.str());
+}
+
+TEST(ResultSinkTest, large)
+{
+    // Write enough records to fill the buffer several times
+    std::ostringstream os;
+    size_type const num_records = 10000;
+    {
+        auto sink = make_result_sink(ResultFormat::ndjson, os);
+        for (size_type i = 0; i < num_records; ++i)
+        {
+            sink->write("label", "0101", i);
+        }
+        EXPECT_GT(os.str().size(), 0);
+    }
+    auto const result = os.str();
+    EXPECT_EQ(num_records,
+              static_cast<size_type>(
+                  std::count(result.begin(), result.end(), '\n')));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
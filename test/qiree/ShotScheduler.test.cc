@@ -0,0 +1,317 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2025 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ShotScheduler.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/ShotScheduler.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/ExternalDistribution.hh"
+#include "qiree/Module.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/RecordedResult.hh"
+#include "qiree/ResultSink.hh"
+#include "qiree/ShotWriter.hh"
+#include "qiree/SingleResultRuntime.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Quantum interface that measures uniformly random bits.
+ */
+class RandomQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    explicit RandomQuantum(unsigned long int seed) : rng_{seed} {}
+
+    void set_up(EntryPointAttrs const& attrs) final
+    {
+        results_.assign(attrs.required_num_results, false);
+    }
+    void tear_down() final {}
+
+    void h(Qubit) final {}
+    void cnot(Qubit, Qubit) final {}
+    void mz(Qubit, Result r) final
+    {
+        QIREE_EXPECT(r.value < results_.size());
+        results_[r.value] = std::bernoulli_distribution{}(rng_);
+    }
+    QState read_result(Result r) const final
+    {
+        QIREE_EXPECT(r.value < results_.size());
+        return static_cast<QState>(static_cast<bool>(results_[r.value]));
+    }
+
+  private:
+    std::mt19937 rng_;
+    std::vector<bool> results_;
+};
+
+//---------------------------------------------------------------------------//
+class RandomRuntime final : public SingleResultRuntime
+{
+  public:
+    explicit RandomRuntime(QuantumInterface const& sim)
+        : SingleResultRuntime{sim}
+    {
+    }
+    void initialize(OptionalCString) final {}
+};
+
+//---------------------------------------------------------------------------//
+class ShotSchedulerTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override
+    {
+        execute_ = std::make_unique<Executor>(
+            Module(this->test_data_path("bell.ll")));
+    }
+
+    static ShotScheduler::Backend make_backend(unsigned long int seed)
+    {
+        auto quantum = std::make_shared<RandomQuantum>(seed);
+        auto runtime = std::make_shared<RandomRuntime>(*quantum);
+        return {std::move(quantum), std::move(runtime)};
+    }
+
+    static size_type total(ResultDistribution const& dist)
+    {
+        size_type result = 0;
+        for (auto const& kv : dist)
+        {
+            result += kv.second;
+        }
+        return result;
+    }
+
+    std::unique_ptr<Executor> execute_;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ShotSchedulerTest, serial)
+{
+    ShotScheduler run_shots{*execute_, make_backend, {1, 12345}};
+    EXPECT_EQ(1, run_shots.num_threads());
+    EXPECT_EQ(12345, run_shots.worker_seed(0));
+    auto dist = run_shots(1000);
+    EXPECT_TRUE(dist.dense());
+    EXPECT_EQ(4, dist.size());
+    EXPECT_EQ(1000, total(dist));
+
+    // Compare against a manual loop
+    ResultDistribution expected;
+    auto backend = make_backend(12345);
+    for (int i = 0; i < 1000; ++i)
+    {
+        (*execute_)(*backend.quantum, *backend.runtime);
+        expected.accumulate(backend.runtime->result());
+    }
+    for (auto const& [key, count] : expected)
+    {
+        EXPECT_EQ(count, dist.count(key)) << key;
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ShotSchedulerTest, multithreaded)
+{
+    ShotScheduler run_shots{*execute_, make_backend, {4, 0}};
+    EXPECT_EQ(4, run_shots.num_threads());
+
+    // Shots are distributed as evenly as possible
+    EXPECT_EQ(3, run_shots.worker_shots(10, 0));
+    EXPECT_EQ(3, run_shots.worker_shots(10, 1));
+    EXPECT_EQ(2, run_shots.worker_shots(10, 2));
+    EXPECT_EQ(2, run_shots.worker_shots(10, 3));
+    EXPECT_EQ(0, run_shots.worker_shots(2, 3));
+    EXPECT_EQ(0, run_shots.worker_seed(0));
+    EXPECT_NE(run_shots.worker_seed(1), run_shots.worker_seed(2));
+
+    auto dist = run_shots(1001);
+    EXPECT_EQ(1001, total(dist));
+
+    // Results are reproducible
+    ShotScheduler run_other{*execute_, make_backend, {4, 0}};
+    auto other = run_other(1001);
+    for (auto const& [key, count] : dist)
+    {
+        EXPECT_EQ(count, other.count(key)) << key;
+    }
+
+    // Fewer shots than threads
+    EXPECT_EQ(2, total(run_shots(2)));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ShotSchedulerTest, shot_writer)
+{
+    std::string const filename = ::testing::TempDir() + "shots.bin";
+    ShotScheduler run_shots{*execute_, make_backend, {3, 0}};
+    ResultDistribution dist;
+    {
+        ShotWriter shots{filename};
+        dist.merge(run_shots(10, &shots));
+        dist.merge(run_shots(5, &shots));
+    }
+    EXPECT_EQ(15, run_shots.num_shots_run());
+
+    std::ifstream infile(filename, std::ios::binary);
+    std::string const data{std::istreambuf_iterator<char>{infile}, {}};
+    auto read_int = [&data](size_type offset, size_type size) {
+        std::uint64_t result = 0;
+        for (size_type i = 0; i < size; ++i)
+        {
+            result |= std::uint64_t(static_cast<unsigned char>(
+                          data[offset + i]))
+                      << (8 * i);
+        }
+        return result;
+    };
+
+    // Header: magic, version, bits, record size
+    ASSERT_EQ(ShotWriter::header_size + 15 * 25, data.size());
+    EXPECT_EQ("QIRS", data.substr(0, 4));
+    EXPECT_EQ(ShotWriter::version, read_int(4, 4));
+    EXPECT_EQ(2, read_int(8, 4));
+    EXPECT_EQ(25, read_int(12, 4));
+
+    // Records are in shot order, and their bits reproduce the distribution
+    ResultDistribution expected;
+    for (size_type shot = 0; shot < 15; ++shot)
+    {
+        auto const offset = ShotWriter::header_size + shot * 25;
+        EXPECT_EQ(shot, read_int(offset, 8));
+        // Shots 0-3 and 10-11 are run by the first worker
+        unsigned int worker = shot < 10 ? (shot < 4 ? 0 : shot < 7 ? 1 : 2)
+                                        : (shot < 12 ? 0 : shot < 14 ? 1 : 2);
+        auto const seed = read_int(offset + 8, 8);
+        auto const position = read_int(offset + 16, 8);
+        EXPECT_EQ(run_shots.worker_seed(worker), seed) << "shot " << shot;
+        auto bits = read_int(offset + 24, 1);
+        expected.accumulate(RecordedResult({bool(bits & 1), bool(bits & 2)}));
+
+        // A new backend with the worker's seed reproduces the shot
+        auto backend = make_backend(seed);
+        for (size_type i = 0; i <= position; ++i)
+        {
+            (*execute_)(*backend.quantum, *backend.runtime);
+        }
+        auto const& result = backend.runtime->result().bits();
+        ASSERT_EQ(2, result.size());
+        EXPECT_EQ(bits, size_type(result[0]) | (size_type(result[1]) << 1))
+            << "shot " << shot;
+    }
+    EXPECT_EQ(5, read_int(ShotWriter::header_size + 11 * 25 + 16, 8));
+    for (auto const& [key, count] : dist)
+    {
+        EXPECT_EQ(count, expected.count(key)) << key;
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ShotSchedulerTest, external)
+{
+    ShotScheduler::Options opts{1, 42};
+    ShotScheduler run_shots{*execute_, make_backend, opts};
+    auto const expected = run_shots(1000);
+
+    // Shots run in batches and spilled to disk match a single run
+    opts.batch_size = 64;
+    ShotScheduler run_batches{*execute_, make_backend, opts};
+    std::string const filename = ::testing::TempDir() + "shots.runs";
+    {
+        // Hold at most 2 keys in memory
+        ExternalDistribution dist{filename, 2 * 2 * 2 * 8};
+        run_batches(1000, dist);
+        EXPECT_EQ(1000, run_batches.num_shots_run());
+        EXPECT_EQ(1000, dist.num_shots());
+        EXPECT_LT(0, dist.num_runs());
+
+        size_type num_keys = 0;
+        dist.for_each_packed([&](auto const* key, size_type count) {
+            auto bits = dist.to_string(key);
+            EXPECT_EQ(expected.count(bits), count) << bits;
+            ++num_keys;
+        });
+        EXPECT_EQ(expected.size(), num_keys);
+
+        // Both distributions are written with the same records
+        auto write_lines = [](auto const& d) {
+            std::ostringstream os;
+            make_result_sink(ResultFormat::ndjson, os)->write("ret", d);
+            std::vector<std::string> lines;
+            std::istringstream is{os.str()};
+            for (std::string line; std::getline(is, line);)
+            {
+                lines.push_back(line);
+            }
+            std::sort(lines.begin(), lines.end());
+            return lines;
+        };
+        EXPECT_EQ(write_lines(expected), write_lines(dist));
+    }
+    EXPECT_FALSE(std::ifstream{filename});
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ShotSchedulerTest, replay)
+{
+    EXPECT_FALSE(execute_->analysis().result_feedback);
+
+    ShotScheduler::Options opts{2, 321};
+    ShotScheduler run_replay{*execute_, make_backend, opts};
+    opts.replay = false;
+    ShotScheduler run_jit{*execute_, make_backend, opts};
+
+    // Replaying calls the backend identically, so results are unchanged
+    for (size_type num_shots : {1, 100})
+    {
+        auto expected = run_jit(num_shots);
+        auto actual = run_replay(num_shots);
+        EXPECT_EQ(num_shots, total(actual));
+        EXPECT_EQ(expected.size(), actual.size());
+        for (auto const& [key, count] : expected)
+        {
+            EXPECT_EQ(count, actual.count(key)) << key;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ShotSchedulerTest, errors)
+{
+    EXPECT_THROW(
+        ShotScheduler(
+            *execute_,
+            [](unsigned long int) { return ShotScheduler::Backend{}; },
+            {3, 0}),
+        RuntimeError);
+
+    // Exceptions from worker threads (here, an unimplemented gate) are
+    // propagated
+    Executor execute_ccx(Module(this->test_data_path("bell_ccx.ll")));
+    ShotScheduler run_shots{execute_ccx, make_backend, {3, 0}};
+    EXPECT_THROW(run_shots(10), DebugError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
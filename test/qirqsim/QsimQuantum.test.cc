@@ -136,11 +136,364 @@ TEST_F(QsimQuantumTest, result_order)
     auto const& result = rt.result();
     EXPECT_EQ("array", result.container_label());
     EXPECT_EQ(expected, result.bits());
-    EXPECT_EQ((std::vector<std::string>{"foo", "bar", "baz"}),
+    EXPECT_EQ((std::vector<std::string_view>{"foo", "bar", "baz"}),
               result.entry_labels());
 
     qis.tear_down();
 }
+//---------------------------------------------------------------------------//
+TEST_F(QsimQuantumTest, terminal_sampling)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    QsimQuantum qis{os, 0};
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+    attrs.required_num_results = 2;
+
+    // Bell state with terminal measurements is simulated only once
+    int num_ones = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        qis.set_up(attrs);
+        qis.h(Q{0});
+        qis.cnot(Q{0}, Q{1});
+        qis.mz(Q{0}, R{0});
+        qis.mz(Q{1}, R{1});
+        auto r0 = qis.read_result(R{0});
+        EXPECT_EQ(r0, qis.read_result(R{1}));
+        num_ones += (r0 == QState::one);
+        qis.tear_down();
+    }
+    EXPECT_EQ(1, qis.num_simulations());
+    EXPECT_LT(20, num_ones);
+    EXPECT_GT(80, num_ones);
+
+    // A gate after a measurement (e.g., conditional on it) means the circuit
+    // must be simulated every shot
+    for (int i = 0; i < 10; ++i)
+    {
+        qis.set_up(attrs);
+        qis.h(Q{0});
+        qis.mz(Q{0}, R{0});
+        if (qis.read_result(R{0}) == QState::one)
+        {
+            qis.x(Q{0});
+        }
+        qis.mz(Q{0}, R{1});
+        EXPECT_EQ(QState::zero, qis.read_result(R{1}));
+        qis.tear_down();
+    }
+    EXPECT_LE(11, qis.num_simulations());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(QsimQuantumTest, read_after_measure)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    QsimQuantum qis{os, 0};
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+    attrs.required_num_results = 2;
+
+    // Reading each result right after its measurement splits the Bell pair
+    // measurements into two batches: the second must see the collapsed state
+    int num_ones = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        qis.set_up(attrs);
+        qis.h(Q{0});
+        qis.cnot(Q{0}, Q{1});
+        qis.mz(Q{0}, R{0});
+        auto r0 = qis.read_result(R{0});
+        qis.mz(Q{1}, R{1});
+        EXPECT_EQ(r0, qis.read_result(R{1})) << "shot " << i;
+        num_ones += (r0 == QState::one);
+        qis.tear_down();
+    }
+    EXPECT_LT(20, num_ones);
+    EXPECT_GT(80, num_ones);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(QsimQuantumTest, long_circuit)
+{
+    using Q = Qubit;
+    using R = Result;
+    constexpr double pi = 3.14159265358979323846;
+    constexpr int num_steps = 40;
+    constexpr int num_shots = 400;
+
+    std::ostringstream os;
+    QsimQuantum qis{os, 0};
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 3;
+    attrs.required_num_results = 4;
+
+    // Well over the fusion window of gates on each side of a mid-circuit
+    // measurement: the rotations add up to RY(2 pi / 3), giving |1> with
+    // probability 3/4, and RY(pi / 3), giving 1/4
+    int num_first = 0;
+    int num_last = 0;
+    for (int i = 0; i < num_shots; ++i)
+    {
+        qis.set_up(attrs);
+        for (int j = 0; j < num_steps; ++j)
+        {
+            qis.ry(2 * pi / 3 / num_steps, Q{0});
+            qis.h(Q{1});
+            qis.cnot(Q{0}, Q{2});
+            qis.h(Q{1});
+            qis.cnot(Q{0}, Q{2});
+        }
+        qis.mz(Q{0}, R{0});
+        QState first = qis.read_result(R{0});
+
+        // Copy the collapsed qubit
+        qis.cnot(Q{0}, Q{1});
+        for (int j = 0; j < num_steps; ++j)
+        {
+            qis.ry(pi / 3 / num_steps, Q{2});
+            qis.h(Q{0});
+            qis.h(Q{0});
+        }
+        qis.mz(Q{0}, R{1});
+        qis.mz(Q{1}, R{2});
+        qis.mz(Q{2}, R{3});
+        EXPECT_EQ(first, qis.read_result(R{1})) << "shot " << i;
+        EXPECT_EQ(first, qis.read_result(R{2})) << "shot " << i;
+        num_first += (first == QState::one);
+        num_last += (qis.read_result(R{3}) == QState::one);
+        qis.tear_down();
+    }
+
+    // Allow about four standard deviations
+    EXPECT_NEAR(0.75, double(num_first) / num_shots, 0.09);
+    EXPECT_NEAR(0.25, double(num_last) / num_shots, 0.09);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(QsimQuantumTest, options)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    QsimQuantum::Options opts;
+    set_option(opts, "max_fused_size", "4");
+    set_option(opts, "num_threads", "1");
+    set_option(opts, "affinity", "none");
+    set_option(opts, "precision", "double");
+    EXPECT_EQ(4, opts.max_fused_size);
+    EXPECT_EQ(1, opts.num_threads);
+    EXPECT_EQ(QsimQuantum::Affinity::none, opts.affinity);
+    EXPECT_EQ(QsimQuantum::Precision::double_, opts.precision);
+    EXPECT_THROW(set_option(opts, "affinity", "scatter"), RuntimeError);
+    EXPECT_THROW(set_option(opts, "num_threads", "-1"), RuntimeError);
+    EXPECT_THROW(set_option(opts, "fused", "2"), RuntimeError);
+
+    std::ostringstream os;
+    {
+        auto bad_opts = opts;
+        bad_opts.max_fused_size = 7;
+        EXPECT_THROW(QsimQuantum(os, 0, bad_opts), RuntimeError);
+    }
+
+    // Simulate in double precision
+    QsimQuantum qis{os, 0, opts};
+    EXPECT_EQ(1, qis.options().num_threads);
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+    attrs.required_num_results = 2;
+    qis.set_up(attrs);
+    qis.x(Q{0});
+    qis.cnot(Q{0}, Q{1});
+    qis.mz(Q{0}, R{0});
+    qis.mz(Q{1}, R{1});
+    EXPECT_EQ(QState::one, qis.read_result(R{0}));
+    EXPECT_EQ(QState::one, qis.read_result(R{1}));
+    qis.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(QsimQuantumTest, gates)
+{
+    using Q = Qubit;
+    using R = Result;
+    constexpr double pi = 3.14159265358979323846;
+
+    std::ostringstream os;
+    QsimQuantum qis{os, 0};
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 3;
+    attrs.required_num_results = 3;
+
+    auto measure_all = [&qis] {
+        std::string result;
+        for (size_type i = 0; i < 3; ++i)
+        {
+            qis.mz(Q{i}, R{i});
+        }
+        for (size_type i = 0; i < 3; ++i)
+        {
+            result.push_back(qis.read_result(R{i}) == QState::one ? '1' : '0');
+        }
+        return result;
+    };
+
+    // Toffoli, controlled Y, and swap
+    qis.set_up(attrs);
+    qis.x(Q{0});
+    qis.ccx(Q{0}, Q{1}, Q{2});  // no-op
+    qis.cy(Q{0}, Q{1});
+    qis.ccx(Q{0}, Q{1}, Q{2});
+    qis.x(Q{0});
+    qis.swap(Q{0}, Q{1});
+    qis.swap(Q{1}, Q{2});
+    EXPECT_EQ("110", measure_all());
+    qis.tear_down();
+
+    // Adjoint phase gates undo their counterparts between Hadamards
+    qis.set_up(attrs);
+    qis.h(Q{0});
+    qis.s(Q{0});
+    qis.s_adj(Q{0});
+    qis.h(Q{0});
+    qis.h(Q{1});
+    qis.t_adj(Q{1});
+    qis.t(Q{1});
+    qis.h(Q{1});
+    qis.h(Q{2});
+    qis.s(Q{2});
+    qis.s(Q{2});
+    qis.h(Q{2});
+    EXPECT_EQ("001", measure_all());
+    qis.tear_down();
+
+    // Two-qubit Pauli rotations by pi flip both qubits
+    for (auto rot : {&QsimQuantum::rxx, &QsimQuantum::ryy})
+    {
+        qis.set_up(attrs);
+        (qis.*rot)(pi, Q{1}, Q{2});
+        EXPECT_EQ("011", measure_all());
+        qis.tear_down();
+    }
+    qis.set_up(attrs);
+    qis.h(Q{0});
+    qis.h(Q{2});
+    qis.rzz(pi, Q{0}, Q{2});
+    qis.h(Q{0});
+    qis.h(Q{2});
+    EXPECT_EQ("101", measure_all());
+    qis.tear_down();
+
+    // Pauli rotations
+    qis.set_up(attrs);
+    qis.r(Pauli::x, pi, Q{0});
+    qis.r(Pauli::y, pi / 2, Q{1});
+    qis.r_adj(Pauli::y, pi / 2, Q{1});
+    qis.r(Pauli::i, pi, Q{2});
+    EXPECT_EQ("100", measure_all());
+    qis.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(QsimQuantumTest, reset)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    QsimQuantum qis{os, 0};
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+    attrs.required_num_results = 2;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        qis.set_up(attrs);
+        // Reset of an untouched qubit is free
+        auto const num_simulations = qis.num_simulations();
+        qis.reset(Q{0});
+        qis.reset(Q{1});
+        EXPECT_EQ(num_simulations, qis.num_simulations());
+
+        qis.h(Q{0});
+        qis.cnot(Q{0}, Q{1});
+        qis.mz(Q{1}, R{1});
+        qis.reset(Q{0});
+        qis.mz(Q{0}, R{0});
+        EXPECT_EQ(QState::zero, qis.read_result(R{0}));
+        qis.x(Q{1});
+        qis.reset(Q{1});
+        qis.mz(Q{1}, R{0});
+        EXPECT_EQ(QState::zero, qis.read_result(R{0}));
+        qis.tear_down();
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(QsimQuantumTest, isa)
+{
+    using Q = Qubit;
+    using R = Result;
+    using Isa = QsimQuantum::Isa;
+
+    QsimQuantum::Options opts;
+    opts.num_threads = 1;
+    set_option(opts, "isa", "basic");
+    EXPECT_EQ(Isa::basic, opts.isa);
+    EXPECT_THROW(set_option(opts, "isa", "neon"), RuntimeError);
+
+    // Double precision is only available without vector instructions
+    {
+        auto double_opts = opts;
+        double_opts.precision = QsimQuantum::Precision::double_;
+        double_opts.isa = Isa::automatic;
+        EXPECT_EQ(Isa::basic, select_isa(double_opts));
+        double_opts.isa = Isa::avx2;
+        EXPECT_THROW(select_isa(double_opts), RuntimeError);
+    }
+
+    // Every available instruction set gives the same deterministic results
+    std::ostringstream os;
+    opts.isa = Isa::automatic;
+    Isa const best = select_isa(opts);
+    EXPECT_NE(Isa::automatic, best);
+    for (auto isa : {Isa::avx512, Isa::avx2, Isa::sse4, Isa::basic})
+    {
+        opts.isa = isa;
+        if (static_cast<int>(isa) < static_cast<int>(best))
+        {
+            // Wider than the automatic choice: not supported here
+            EXPECT_THROW(select_isa(opts), RuntimeError);
+            continue;
+        }
+        QsimQuantum qis{os, 0, opts};
+        EXPECT_EQ(isa, qis.isa()) << to_cstring(isa);
+
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = 3;
+        attrs.required_num_results = 3;
+        qis.set_up(attrs);
+        qis.x(Q{0});
+        qis.h(Q{1});
+        qis.h(Q{1});
+        qis.cnot(Q{0}, Q{2});
+        qis.mz(Q{0}, R{0});
+        qis.mz(Q{1}, R{1});
+        qis.mz(Q{2}, R{2});
+        EXPECT_EQ(QState::one, qis.read_result(R{0})) << to_cstring(isa);
+        EXPECT_EQ(QState::zero, qis.read_result(R{1})) << to_cstring(isa);
+        EXPECT_EQ(QState::one, qis.read_result(R{2})) << to_cstring(isa);
+        qis.tear_down();
+    }
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
@@ -8,10 +8,13 @@
 #include "qirxacc/XaccQuantum.hh"
 
 #include <regex>
+#include <sstream>
 
+#include "qiree/ResultSink.hh"
 #include "qiree/Types.hh"
 #include "qiree_test.hh"
 #include "qirxacc/XaccDefaultRuntime.hh"
+#include "qirxacc/XaccTupleRuntime.hh"
 
 namespace qiree
 {
@@ -102,6 +105,224 @@ qubit 0 experiment tag: {0: 1, 1: 0}
         << result;
 }
 
+TEST_F(XaccQuantumTest, sink_output)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 1;
+    attrs.required_num_results = 1;
+
+    for (bool tuples : {false, true})
+    {
+        // Everything shares one stream, as with qir-xacc writing to stdout
+        std::ostringstream os;
+        XaccQuantum xacc_sim{os};
+        auto sink = make_result_sink(ResultFormat::ndjson, os);
+        std::unique_ptr<RuntimeInterface> rt;
+        if (tuples)
+        {
+            rt = std::make_unique<XaccTupleRuntime>(
+                os, xacc_sim, /* print_accelbuf = */ true, sink.get());
+        }
+        else
+        {
+            rt = std::make_unique<XaccDefaultRuntime>(
+                os, xacc_sim, /* print_accelbuf = */ true, sink.get());
+        }
+
+        rt->initialize("env");
+        xacc_sim.set_up(attrs);
+        xacc_sim.x(Q{0});
+        xacc_sim.mz(Q{0}, R{0});
+        rt->array_record_output(1, "ret");
+        rt->result_record_output(R{0}, "ret");
+        xacc_sim.tear_down();
+        sink->flush();
+
+        // The stream holds only records
+        std::string expected = R"({"label":"ret","bits":"1","count":1})"
+                               "\n";
+        if (!tuples)
+        {
+            expected = R"({"label":"ret","bits":"0","count":0})"
+                       "\n"
+                       + expected;
+        }
+        EXPECT_EQ(expected, os.str()) << "tuples: " << tuples;
+    }
+}
+
+TEST_F(XaccQuantumTest, dynamic)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    XaccQuantum::Options opts;
+    opts.shots = 64;
+    opts.dynamic = true;
+    XaccQuantum xacc_sim{os, "aer", opts};
+
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+    attrs.required_num_results = 2;
+    for (int i = 0; i < 8; ++i)
+    {
+        // Copy a random bit to the second qubit with feed-forward
+        xacc_sim.set_up(attrs);
+        xacc_sim.h(Q{0});
+        xacc_sim.mz(Q{0}, R{0});
+        QState first = xacc_sim.read_result(R{0});
+        if (first == QState::one)
+        {
+            xacc_sim.x(Q{1});
+        }
+        xacc_sim.mz(Q{1}, R{1});
+        EXPECT_EQ(first, xacc_sim.read_result(R{1}));
+        EXPECT_EQ(first, xacc_sim.read_result(R{0}));
+        xacc_sim.tear_down();
+    }
+
+    // One prefix for the first read, and at most one for each branch
+    EXPECT_LE(xacc_sim.num_executions(), 3);
+}
+
+TEST_F(XaccQuantumTest, circuit_cache)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    XaccQuantum xacc_sim{os, "aer", 64};
+
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+    attrs.required_num_results = 2;
+    attrs.entry_point = "main";
+    attrs.module_hash = "0123456789abcdef";
+
+    std::vector<bool> from_cache;
+    for (int i = 0; i < 2; ++i)
+    {
+        // Deterministic circuit with two different measured values
+        xacc_sim.set_up(attrs);
+        from_cache.push_back(xacc_sim.from_cache());
+        xacc_sim.x(Q{0});
+        xacc_sim.swap(Q{0}, Q{1});
+        xacc_sim.mz(Q{0}, R{0});
+        xacc_sim.mz(Q{1}, R{1});
+        ASSERT_TRUE(xacc_sim.execute_if_needed());
+        EXPECT_EQ(1, xacc_sim.result_to_qubit(R{1}).value);
+        auto counts = xacc_sim.get_marginal_counts({Q{0}, Q{1}});
+        EXPECT_EQ(64, counts["01"]) << "iteration " << i;
+        xacc_sim.tear_down();
+    }
+    EXPECT_EQ((std::vector<bool>{false, true}), from_cache);
+
+    // Programs without a hash are never cached
+    attrs.module_hash.clear();
+    xacc_sim.set_up(attrs);
+    EXPECT_FALSE(xacc_sim.from_cache());
+    xacc_sim.tear_down();
+}
+
+TEST_F(XaccQuantumTest, disk_circuit_cache)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    XaccQuantum::Options opts;
+    opts.shots = 64;
+    opts.cache_dir = ::testing::TempDir() + "qiree-xacc-circuit-cache";
+
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 2;
+    attrs.required_num_results = 2;
+    attrs.entry_point = "main";
+    attrs.module_hash = "fedcba9876543210";
+
+    // Each simulator has its own in-memory cache, so the second one can only
+    // reuse the circuit from disk
+    std::vector<bool> from_cache;
+    for (int i = 0; i < 2; ++i)
+    {
+        std::ostringstream os;
+        XaccQuantum xacc_sim{os, "aer", opts};
+        xacc_sim.set_up(attrs);
+        from_cache.push_back(xacc_sim.from_cache());
+        xacc_sim.x(Q{0});
+        xacc_sim.swap(Q{0}, Q{1});
+        xacc_sim.mz(Q{1}, R{0});
+        xacc_sim.mz(Q{0}, R{1});
+        ASSERT_TRUE(xacc_sim.execute_if_needed()) << os.str();
+        EXPECT_EQ(1, xacc_sim.result_to_qubit(R{0}).value);
+        EXPECT_EQ(0, xacc_sim.result_to_qubit(R{1}).value);
+        auto counts = xacc_sim.get_marginal_counts({Q{0}, Q{1}});
+        EXPECT_EQ(64, counts["01"]) << "instance " << i;
+        EXPECT_EQ(1, counts.size()) << "instance " << i;
+        xacc_sim.tear_down();
+        EXPECT_EQ(std::string::npos, os.str().find("Failed")) << os.str();
+    }
+
+    // The first simulator may reuse a circuit from a previous test run
+    EXPECT_TRUE(from_cache.back());
+}
+
+TEST_F(XaccQuantumTest, native_gates)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 3;
+    attrs.required_num_results = 3;
+
+    for (bool native : {true, false})
+    {
+        std::ostringstream os;
+        XaccQuantum::Options opts;
+        opts.shots = 16;
+        opts.native_gates = native;
+        XaccQuantum xacc_sim{os, "aer", opts};
+        EXPECT_EQ(native, xacc_sim.capabilities().swap);
+
+        // Toffoli and SWAP give the same result with or without
+        // decomposition
+        xacc_sim.set_up(attrs);
+        xacc_sim.x(Q{0});
+        xacc_sim.x(Q{1});
+        xacc_sim.ccx(Q{0}, Q{1}, Q{2});
+        xacc_sim.swap(Q{1}, Q{2});
+        xacc_sim.x(Q{1});
+        for (auto i : {0, 1, 2})
+        {
+            xacc_sim.mz(Q{static_cast<size_type>(i)},
+                        R{static_cast<size_type>(i)});
+        }
+        ASSERT_TRUE(xacc_sim.execute_if_needed());
+        auto counts = xacc_sim.get_marginal_counts({Q{0}, Q{1}, Q{2}});
+        EXPECT_EQ(16, counts["101"]) << "native: " << native;
+        xacc_sim.tear_down();
+    }
+
+    // The table of native gates is configurable
+    std::ostringstream os;
+    XaccQuantum::Options opts;
+    opts.native_capabilities["aer"].swap = false;
+    {
+        XaccQuantum xacc_sim{os, "aer:statevector", opts};
+        EXPECT_FALSE(xacc_sim.capabilities().swap);
+    }
+    opts.native_capabilities.clear();
+    {
+        XaccQuantum xacc_sim{os, "aer", opts};
+        EXPECT_FALSE(xacc_sim.capabilities().swap);
+        EXPECT_FALSE(xacc_sim.capabilities().ccx);
+    }
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree